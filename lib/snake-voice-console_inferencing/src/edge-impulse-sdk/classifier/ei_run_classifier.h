@@ -458,17 +458,24 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
     memset(result, 0, sizeof(ei_impulse_result_t));
 
-    // smart pointer to results array
-    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[handle->impulse->learning_blocks_size]);
-    result->_raw_outputs = raw_results_ptr.get();
-    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
-
+    // the rolling features outlive every slice, so they must be built on the
+    // heap before the scratch scope opens (the arena is reset after a slice)
     auto impulse = handle->impulse;
     static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
     if (!static_features_matrix.buffer) {
         return EI_IMPULSE_ALLOC_FAILED;
     }
 
+    // DSP temporaries and the per-call result and feature arrays come from
+    // the scratch arena sized in run_classifier_init()
+    ei_dsp_scratch_scope_t dsp_scratch;
+
+    ei_dsp_scratch_array_t<ei_feature_t> raw_results(impulse->learning_blocks_size);
+    if (impulse->learning_blocks_size > 0 && raw_results.get() == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+    result->_raw_outputs = raw_results.get();
+
     EI_IMPULSE_ERROR ei_impulse_error = EI_IMPULSE_OK;
 
     uint64_t dsp_start_us = ei_read_timer_us();
@@ -543,18 +550,16 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
         uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
 
-        // smart pointer to features array
-        std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
+        ei_dsp_scratch_array_t<ei_feature_t> features_ptr(block_num);
         ei_feature_t* features = features_ptr.get();
         if (features == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate features\n");
             return EI_IMPULSE_ALLOC_FAILED;
         }
-        memset(features, 0, sizeof(ei_feature_t) * block_num);
 
         // have it outside of the loop to avoid going out of scope
-        std::unique_ptr<ei::matrix_t> *matrix_ptrs = new std::unique_ptr<ei::matrix_t>[block_num];
-        if (matrix_ptrs == nullptr) {
+        ei_dsp_scratch_array_t<std::unique_ptr<ei::matrix_t>> matrix_ptrs(block_num);
+        if (matrix_ptrs.get() == nullptr) {
             ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
             return EI_IMPULSE_ALLOC_FAILED;
         }
@@ -572,7 +577,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
             if (matrix_ptrs[ix]->buffer == nullptr) {
                 ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                delete[] matrix_ptrs;
                 return EI_IMPULSE_ALLOC_FAILED;
             }
 
@@ -609,8 +613,10 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
             ei_printf("Running impulse...\n");
         }
 
+        // the NN isn't part of the DSP scratch budget
+        ei_dsp_scratch_end();
+
         ei_impulse_error = run_inference(handle, features, result, debug);
-        delete[] matrix_ptrs;
         ei_impulse_error = run_postprocessing(handle, result);
     }
 
@@ -829,6 +835,7 @@ extern "C" void run_classifier_init(void)
 
     classifier_continuous_features_written = 0;
     ei_dsp_clear_continuous_audio_state();
+    ei_dsp_scratch_init(continuous_dsp_scratch_bytes(ei_default_impulse.impulse));
     init_impulse(&ei_default_impulse);
     init_postprocessing(&ei_default_impulse);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
@@ -854,6 +861,7 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 {
     classifier_continuous_features_written = 0;
     ei_dsp_clear_continuous_audio_state();
+    ei_dsp_scratch_init(continuous_dsp_scratch_bytes(handle->impulse));
     init_impulse(handle);
     init_postprocessing(handle);
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
@@ -941,7 +949,10 @@ extern "C" EI_IMPULSE_ERROR run_classifier_continuous(
     bool enable_maf_unused = true)
 {
     auto& impulse = ei_default_impulse;
-    return process_impulse_continuous(&impulse, signal, result, debug);
+    EI_IMPULSE_ERROR res = process_impulse_continuous(&impulse, signal, result, debug);
+    // all DSP temporaries of this slice are freed by now
+    ei_dsp_scratch_reset();
+    return res;
 }
 
 /**
@@ -1001,7 +1012,10 @@ __attribute__((unused)) EI_IMPULSE_ERROR run_classifier_continuous(
     bool debug = false,
     bool enable_maf_unused = true)
 {
-    return process_impulse_continuous(impulse, signal, result, debug);
+    EI_IMPULSE_ERROR res = process_impulse_continuous(impulse, signal, result, debug);
+    // all DSP temporaries of this slice are freed by now
+    ei_dsp_scratch_reset();
+    return res;
 }
 
 /**
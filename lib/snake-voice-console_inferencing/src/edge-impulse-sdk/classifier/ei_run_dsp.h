@@ -267,9 +267,12 @@ __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matr
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->num_cepstral,
             implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
+    // the output matrix is a rolling cache of per-frame features: drop the
+    // oldest frames so we have room at the end. The tail is overwritten
+    // below, so a plain shift is enough (roll would allocate a temporary of
+    // nearly the whole matrix on every slice)
+    x = numpy::shift_left(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
+        out_matrix_size.rows * out_matrix_size.cols);
     if (x != EIDSP_OK) {
         EIDSP_ERR(x);
     }
@@ -406,9 +409,10 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
             EIDSP_ERR(x);
         }
 
-        // if there's overlap between frames we roll through
+        // if there's overlap between frames we roll through (the tail is
+        // refilled before it's used again, so it doesn't need to wrap)
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::shift_left(ei_dsp_cont_current_frame, frame_length_values, frame_stride_values);
         }
 
         ei_dsp_cont_current_frame_ix -= frame_stride_values;
@@ -467,6 +471,88 @@ __attribute__((unused)) int extract_mfcc_per_slice_features(signal_t *signal, ma
 #endif
 }
 
+/**
+ * @brief      Upper bound on the DSP scratch memory one continuous MFCC slice
+ *             needs: the MFCC stage (features, frame indices, mel points,
+ *             power spectrum, frame, FFT buffers) or the normalization stage,
+ *             whichever is larger, plus per-block header and alignment slack.
+ *
+ * @param      config              ei_dsp_config_mfcc_t struct pointer
+ * @param[in]  sampling_frequency  The sampling frequency
+ * @param[in]  slice_size          Samples per slice
+ * @param[in]  n_output_features   Features in the full window
+ *
+ * @return     Bytes
+ */
+__attribute__((unused)) static size_t mfcc_per_slice_scratch_bytes(ei_dsp_config_mfcc_t *config, const float sampling_frequency, size_t slice_size, size_t n_output_features)
+{
+    const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
+    const int implementation_version =
+        config->implementation_version == 1 ? 2 : config->implementation_version;
+
+    // the first slice carries the leftover frame, so allow one extra row
+    matrix_size_t slice_matrix_size = speechpy::feature::calculate_mfcc_buffer_size(
+        slice_size, frequency, config->frame_length, config->frame_stride, config->num_cepstral,
+        implementation_version);
+    const size_t rows = slice_matrix_size.rows + 1;
+
+    const size_t frame_length_values = frequency * config->frame_length;
+    const size_t fft_bins = config->fft_length / 2 + 1;
+
+    size_t fft_cfg_bytes = 2 * config->fft_length * sizeof(float);
+#if EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)
+    size_t kiss_fftr_mem_length = 0;
+    kiss_fftr_alloc(config->fft_length, 0, NULL, &kiss_fftr_mem_length);
+    fft_cfg_bytes = std::max(fft_cfg_bytes, kiss_fftr_mem_length);
+#endif
+
+    const size_t mfcc_bytes =
+        rows * (config->num_filters + 1) * sizeof(float) +  // mfe features + energies
+        rows * sizeof(uint32_t) +                           // frame indices
+        (config->num_filters + 2) * sizeof(float) +         // mel points
+        fft_bins * sizeof(float) +                          // power spectrum frame
+        frame_length_values * sizeof(float) +               // signal frame
+        fft_bins * sizeof(fft_complex_t) +                  // fft output
+        config->fft_length * sizeof(float) +                // fft input
+        fft_cfg_bytes;
+
+    const size_t norm_bytes =
+        sizeof(matrix_t) +
+        n_output_features * sizeof(float) +
+        (n_output_features / config->num_cepstral) * sizeof(float);
+
+    return std::max(mfcc_bytes, norm_bytes) + 64 * 16;
+}
+
+/**
+ * @brief      Scratch arena size for run_classifier_continuous with this
+ *             impulse; 0 if no block runs from the arena.
+ */
+__attribute__((unused)) static size_t continuous_dsp_scratch_bytes(const ei_impulse_t *impulse)
+{
+    size_t bytes = 0;
+
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        ei_model_dsp_t block = impulse->dsp_blocks[ix];
+
+        if (block.extract_fn == &extract_mfcc_features) {
+            bytes = std::max(bytes, mfcc_per_slice_scratch_bytes(
+                (ei_dsp_config_mfcc_t *)block.config, impulse->frequency, impulse->slice_size,
+                block.n_output_features));
+        }
+    }
+
+    if (bytes > 0) {
+        // process_impulse_continuous keeps its result, feature and matrix
+        // pointer arrays in the arena too, each with its block header
+        const size_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
+        bytes += (impulse->learning_blocks_size + block_num) * sizeof(ei_feature_t) +
+            block_num * sizeof(std::unique_ptr<matrix_t>) + 3 * 16;
+    }
+
+    return bytes;
+}
+
 __attribute__((unused)) int extract_spectrogram_features(signal_t *signal, matrix_t *output_matrix, void *config_ptr, const float sampling_frequency) {
     ei_dsp_config_spectrogram_t config = *((ei_dsp_config_spectrogram_t*)config_ptr);
 
@@ -535,9 +621,12 @@ __attribute__((unused)) static int extract_spectrogram_run_slice(signal_t *signa
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->fft_length / 2 + 1,
             config->implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
+    // the output matrix is a rolling cache of per-frame features: drop the
+    // oldest frames so we have room at the end. The tail is overwritten
+    // below, so a plain shift is enough (roll would allocate a temporary of
+    // nearly the whole matrix on every slice)
+    x = numpy::shift_left(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
+        out_matrix_size.rows * out_matrix_size.cols);
     if (x != EIDSP_OK) {
         if (preemphasis) {
             delete preemphasis;
@@ -670,9 +759,10 @@ __attribute__((unused)) int extract_spectrogram_per_slice_features(signal_t *sig
             EIDSP_ERR(x);
         }
 
-        // if there's overlap between frames we roll through
+        // if there's overlap between frames we roll through (the tail is
+        // refilled before it's used again, so it doesn't need to wrap)
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::shift_left(ei_dsp_cont_current_frame, frame_length_values, frame_stride_values);
         }
 
         ei_dsp_cont_current_frame_ix -= frame_stride_values;
@@ -846,9 +936,12 @@ __attribute__((unused)) static int extract_mfe_run_slice(signal_t *signal, matri
             signal->total_length, frequency, config->frame_length, config->frame_stride, config->num_filters,
             config->implementation_version);
 
-    // we roll the output matrix back so we have room at the end...
-    x = numpy::roll(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
-        -(out_matrix_size.rows * out_matrix_size.cols));
+    // the output matrix is a rolling cache of per-frame features: drop the
+    // oldest frames so we have room at the end. The tail is overwritten
+    // below, so a plain shift is enough (roll would allocate a temporary of
+    // nearly the whole matrix on every slice)
+    x = numpy::shift_left(output_matrix->buffer, output_matrix->rows * output_matrix->cols,
+        out_matrix_size.rows * out_matrix_size.cols);
     if (x != EIDSP_OK) {
         EIDSP_ERR(x);
     }
@@ -1033,9 +1126,10 @@ __attribute__((unused)) int extract_mfe_per_slice_features(signal_t *signal, mat
             EIDSP_ERR(x);
         }
 
-        // if there's overlap between frames we roll through
+        // if there's overlap between frames we roll through (the tail is
+        // refilled before it's used again, so it doesn't need to wrap)
         if (frame_stride_values > 0) {
-            numpy::roll(ei_dsp_cont_current_frame, frame_length_values, -frame_stride_values);
+            numpy::shift_left(ei_dsp_cont_current_frame, frame_length_values, frame_stride_values);
         }
 
         ei_dsp_cont_current_frame_ix -= frame_stride_values;
@@ -56,7 +56,7 @@ static int hw_r2c_fft(const float *input, ei::fft_complex_t *output_as_complex,
     int err = 0;
 
     // Prepare input as complex numbers (real part, imaginary part)
-    float *complex_input = (float*)ei_malloc(n_fft * sizeof(float) * 2);
+    float *complex_input = (float*)ei_dsp_malloc(n_fft * sizeof(float) * 2);
     if (complex_input == nullptr) {
         EI_LOGE("Failed to allocate memory for complex input\n");
         goto out;
@@ -81,7 +81,7 @@ static int hw_r2c_fft(const float *input, ei::fft_complex_t *output_as_complex,
         output[i] = complex_input[i];
     }
 out:
-    ei_free(complex_input);
+    ei_dsp_free(complex_input, n_fft * sizeof(float) * 2);
     return 0;
 }
 
@@ -28,7 +28,139 @@
  * either express or implied. See the License for the specific language governing
  * permissions, disclaimers and limitations under the License.
  */
+#include <assert.h>
+#include <string.h>
 #include "memory.hpp"
+#include "returntypes.hpp"
 
 size_t ei_memory_in_use = 0;
 size_t ei_memory_peak_use = 0;
+
+namespace ei {
+
+// Every arena block starts with a header linking it to the block below, so
+// the top can be popped back through blocks that were freed out of order
+typedef struct {
+    uint32_t prev;  // offset of the block below, SCRATCH_NONE for the first
+    uint32_t freed;
+} scratch_block_t;
+
+#define SCRATCH_NONE   0xFFFFFFFFu
+#define SCRATCH_ALIGN  8
+
+static uint8_t *scratch_base = nullptr;
+static size_t scratch_size = 0;
+static size_t scratch_top = 0;              // first free byte
+static uint32_t scratch_last = SCRATCH_NONE; // offset of the topmost block
+static size_t scratch_peak = 0;
+static size_t scratch_fallback_count = 0;
+static size_t scratch_live = 0;              // arena blocks not freed yet
+static bool scratch_open = false;
+
+int ei_dsp_scratch_init(size_t bytes) {
+    if (scratch_base && scratch_size == bytes) {
+        ei_dsp_scratch_reset();
+        return EIDSP_OK;
+    }
+
+    if (scratch_base) {
+        ei_free(scratch_base);
+        scratch_base = nullptr;
+        scratch_size = 0;
+    }
+    ei_dsp_scratch_reset();
+
+    if (bytes == 0) {
+        return EIDSP_OK;
+    }
+
+    scratch_base = (uint8_t*)ei_malloc(bytes);
+    if (!scratch_base) {
+        return EIDSP_OUT_OF_MEM;
+    }
+    scratch_size = bytes;
+    return EIDSP_OK;
+}
+
+void ei_dsp_scratch_begin() {
+    scratch_open = scratch_base != nullptr;
+}
+
+void ei_dsp_scratch_end() {
+    scratch_open = false;
+}
+
+void ei_dsp_scratch_reset() {
+    // a block still live here (e.g. a static matrix_t built inside a scope)
+    // would dangle and get overwritten by the next slice's temporaries
+    assert(scratch_live == 0 && "DSP scratch block outlived its scope");
+    scratch_live = 0;
+    scratch_open = false;
+    scratch_top = 0;
+    scratch_last = SCRATCH_NONE;
+}
+
+void *ei_dsp_scratch_alloc(size_t bytes, bool zero) {
+    if (scratch_open) {
+        size_t need = sizeof(scratch_block_t) + ((bytes + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1));
+        if (scratch_top + need <= scratch_size) {
+            scratch_block_t *block = (scratch_block_t*)(scratch_base + scratch_top);
+            block->prev = scratch_last;
+            block->freed = 0;
+            scratch_last = (uint32_t)scratch_top;
+            scratch_top += need;
+            scratch_live++;
+            if (scratch_top > scratch_peak) {
+                scratch_peak = scratch_top;
+            }
+
+            void *ptr = block + 1;
+            if (zero) {
+                memset(ptr, 0, bytes);
+            }
+            return ptr;
+        }
+        scratch_fallback_count++;
+    }
+
+    return zero ? ei_calloc(bytes, 1) : ei_malloc(bytes);
+}
+
+void ei_dsp_scratch_free(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    uint8_t *p = (uint8_t*)ptr;
+    if (p < scratch_base || p >= scratch_base + scratch_size) {
+        ei_free(ptr);
+        return;
+    }
+
+    ((scratch_block_t*)p - 1)->freed = 1;
+    scratch_live--;
+
+    // pop every freed block off the top
+    while (scratch_last != SCRATCH_NONE) {
+        scratch_block_t *top = (scratch_block_t*)(scratch_base + scratch_last);
+        if (!top->freed) {
+            break;
+        }
+        scratch_top = scratch_last;
+        scratch_last = top->prev;
+    }
+}
+
+size_t ei_dsp_scratch_peak() {
+    return scratch_peak;
+}
+
+size_t ei_dsp_scratch_fallbacks() {
+    return scratch_fallback_count;
+}
+
+size_t ei_dsp_scratch_live() {
+    return scratch_live;
+}
+
+} // namespace ei
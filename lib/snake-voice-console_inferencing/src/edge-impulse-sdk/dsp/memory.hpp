@@ -35,6 +35,7 @@
 #include <functional>
 #include <stdio.h>
 #include <memory>
+#include <new>
 #include "../porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
 #include "config.hpp"
@@ -64,6 +65,68 @@ typedef std::unique_ptr<void, std::function<void(void*)>> ei_unique_ptr_t;
 
 namespace ei {
 
+/**
+ * Scratch arena for DSP temporaries (matrices, FFT and DCT buffers,
+ * ei_vector storage). One block is allocated up front; while a scratch
+ * scope is open, ei_dsp_malloc/ei_dsp_calloc and matrix_t buffers are
+ * served from it stack-wise, so steady-state DSP doesn't touch the heap.
+ * Blocks freed out of order are reclaimed as soon as everything above
+ * them is freed. Requests that don't fit (or any request while no scope
+ * is open) go to ei_malloc/ei_calloc as before.
+ */
+int ei_dsp_scratch_init(size_t bytes);  // (re)allocate the arena, 0 frees it
+void ei_dsp_scratch_begin();            // route DSP allocations to the arena
+void ei_dsp_scratch_end();              // back to the heap; live blocks stay valid
+void ei_dsp_scratch_reset();            // drop everything, call after each impulse;
+                                        // asserts that no arena block is still live
+void *ei_dsp_scratch_alloc(size_t bytes, bool zero);
+void ei_dsp_scratch_free(void *ptr);    // arena or heap pointer
+size_t ei_dsp_scratch_peak();           // high-water mark, in bytes
+size_t ei_dsp_scratch_fallbacks();      // requests that went to the heap in scope
+size_t ei_dsp_scratch_live();           // arena blocks allocated and not yet freed
+
+// Keeps a scratch scope open for its lifetime (closed on early returns too)
+struct ei_dsp_scratch_scope_t {
+    ei_dsp_scratch_scope_t() { ei_dsp_scratch_begin(); }
+    ~ei_dsp_scratch_scope_t() { ei_dsp_scratch_end(); }
+};
+
+// Value-initialized array of T from ei_dsp_scratch_alloc (the arena while a
+// scope is open), destroyed and freed with this object. get() is nullptr if
+// the allocation failed.
+template<typename T>
+class ei_dsp_scratch_array_t {
+public:
+    explicit ei_dsp_scratch_array_t(size_t count) : _count(count) {
+        _items = (T*)ei_dsp_scratch_alloc(count * sizeof(T), false);
+        if (_items) {
+            for (size_t ix = 0; ix < _count; ix++) {
+                ::new (&_items[ix]) T();
+            }
+        }
+    }
+
+    ~ei_dsp_scratch_array_t() {
+        if (!_items) {
+            return;
+        }
+        for (size_t ix = _count; ix > 0; ix--) {
+            _items[ix - 1].~T();
+        }
+        ei_dsp_scratch_free(_items);
+    }
+
+    ei_dsp_scratch_array_t(const ei_dsp_scratch_array_t&) = delete;
+    ei_dsp_scratch_array_t& operator=(const ei_dsp_scratch_array_t&) = delete;
+
+    T *get() { return _items; }
+    T &operator[](size_t ix) { return _items[ix]; }
+
+private:
+    T *_items;
+    size_t _count;
+};
+
 /**
  * These are macros used to track allocations when running DSP processes.
  * Enable memory tracking through the EIDSP_TRACK_ALLOCATIONS macro.
@@ -138,9 +201,9 @@ namespace ei {
     #define ei_dsp_register_matrix_alloc(...) (void)0
     #define ei_dsp_register_free(...) (void)0
     #define ei_dsp_register_matrix_free(...) (void)0
-    #define ei_dsp_malloc ei_malloc
-    #define ei_dsp_calloc ei_calloc
-    #define ei_dsp_free(ptr, size) ei_free(ptr)
+    #define ei_dsp_malloc(size) ::ei::ei_dsp_scratch_alloc((size), false)
+    #define ei_dsp_calloc(num, size) ::ei::ei_dsp_scratch_alloc((num) * (size), true)
+    #define ei_dsp_free(ptr, size) ::ei::ei_dsp_scratch_free(ptr)
     #define EI_DSP_MATRIX(name, ...) matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
     #define EI_DSP_MATRIX_B(name, ...) matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
     #define EI_DSP_QUANTIZED_MATRIX(name, ...) quantized_matrix_t name(__VA_ARGS__); if (!name.buffer) { EIDSP_ERR(EIDSP_OUT_OF_MEM); }
@@ -157,7 +220,7 @@ public:
      * @param size The size of the memory block, in bytes.
      */
     static void *ei_wrapped_malloc(const char *fn, const char *file, int line, size_t size) {
-        void *ptr = ei_malloc(size);
+        void *ptr = ei_dsp_scratch_alloc(size, false);
         if (ptr) {
             ei_dsp_register_alloc_internal(fn, file, line, size, ptr);
         }
@@ -171,7 +234,7 @@ public:
      * @param size Size of each element
      */
     static void *ei_wrapped_calloc(const char *fn, const char *file, int line, size_t num, size_t size) {
-        void *ptr = ei_calloc(num, size);
+        void *ptr = ei_dsp_scratch_alloc(num * size, true);
         if (ptr) {
             ei_dsp_register_alloc_internal(fn, file, line, num * size, ptr);
         }
@@ -184,7 +247,7 @@ public:
      * @param size Size of the block of memory previously allocated.
      */
     static void ei_wrapped_free(const char *fn, const char *file, int line, void *ptr, size_t size) {
-        ei_free(ptr);
+        ei_dsp_scratch_free(ptr);
         ei_dsp_register_free_internal(fn, file, line, size, ptr);
     }
 };
@@ -192,7 +255,7 @@ public:
 
 // This needs to be a real function so I can bind with a lambda
 __attribute__((unused)) static void ei_dsp_free_func(void *ptr, size_t size) {
-    ei_free(ptr);
+    ei_dsp_scratch_free(ptr);
 #if EIDSP_TRACK_ALLOCATIONS
     ei_dsp_register_free_internal("unique_ptr free", "", 0, size, ptr);
 #endif
@@ -212,7 +275,7 @@ static ei_unique_ptr_t make_tracked_unique_ptr(void* ptr_in, size_t size) {
     auto ptr = reinterpret_cast<void**>(ptr_in);
     *ptr = ei_dsp_malloc(size);
     return ei_unique_ptr_t(*ptr, [size](void *ptr) {
-        ei_free(ptr);
+        ei_dsp_scratch_free(ptr);
         ei_dsp_register_free_internal("unique_ptr", "", 0, size, ptr);
     });
 }
@@ -231,8 +294,8 @@ __attribute__((warn_unused_result)) __attribute__((unused))
 static ei_unique_ptr_t make_tracked_unique_ptr(void* ptr_in, size_t size)
 {
     auto ptr = reinterpret_cast<void**>(ptr_in);
-    *ptr = ei_malloc(size);
-    return ei_unique_ptr_t(*ptr, ei_free);
+    *ptr = ei_dsp_scratch_alloc(size, false);
+    return ei_unique_ptr_t(*ptr, ei_dsp_scratch_free);
 }
 #endif
 
@@ -164,6 +164,30 @@ public:
         return EIDSP_OK;
     }
 
+    /**
+     * Shift array elements towards the start, discarding the first `shift`.
+     * Like roll(input_array, input_array_size, -shift), but the last `shift`
+     * elements are left as they were instead of wrapping around, so no
+     * temporary buffer is needed. Use it when the tail is overwritten next.
+     * @param input_array
+     * @param input_array_size
+     * @param shift The number of places by which elements are shifted.
+     * @returns EIDSP_OK if OK
+     */
+    static int shift_left(float *input_array, size_t input_array_size, size_t shift) {
+        if (shift > input_array_size) {
+            EIDSP_ERR(EIDSP_OUT_OF_BOUNDS);
+        }
+
+        if (shift == 0 || shift == input_array_size) {
+            return EIDSP_OK;
+        }
+
+        memmove(input_array, input_array + shift, (input_array_size - shift) * sizeof(float));
+
+        return EIDSP_OK;
+    }
+
     /**
      * Roll array elements along a given axis.
      * Elements that roll beyond the last position are re-introduced at the first.
@@ -1744,15 +1768,20 @@ public:
     static int software_rfft(float *fft_input, fft_complex_t *output, size_t n_fft, size_t n_fft_out_features)
     {
     #if EIDSP_INCLUDE_KISSFFT || !defined(EIDSP_INCLUDE_KISSFFT)
-        // create fftr context
-        size_t kiss_fftr_mem_length;
+        // create fftr context, in DSP scratch memory (ask kissfft for the size first)
+        size_t kiss_fftr_mem_length = 0;
+        kiss_fftr_alloc(n_fft, 0, NULL, &kiss_fftr_mem_length);
 
-        kiss_fftr_cfg cfg = kiss_fftr_alloc(n_fft, 0, NULL, NULL, &kiss_fftr_mem_length);
-        if (!cfg) {
+        void *kiss_fftr_mem = ei_dsp_malloc(kiss_fftr_mem_length);
+        if (!kiss_fftr_mem) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
 
-        ei_dsp_register_alloc(kiss_fftr_mem_length, cfg);
+        kiss_fftr_cfg cfg = kiss_fftr_alloc(n_fft, 0, kiss_fftr_mem, &kiss_fftr_mem_length);
+        if (!cfg) {
+            ei_dsp_free(kiss_fftr_mem, kiss_fftr_mem_length);
+            EIDSP_ERR(EIDSP_OUT_OF_MEM);
+        }
 
         // execute the rfft operation
         kiss_fftr(cfg, fft_input, (kiss_fft_cpx*)output);
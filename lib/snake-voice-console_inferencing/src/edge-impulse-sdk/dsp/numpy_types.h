@@ -104,7 +104,7 @@ typedef struct ei_matrix {
             buffer_managed_by_me = false;
         }
         else {
-            buffer = (float*)ei_calloc(n_rows * n_cols * sizeof(float), 1);
+            buffer = (float*)ei_dsp_scratch_alloc(n_rows * n_cols * sizeof(float), true);
             buffer_managed_by_me = true;
         }
         rows = n_rows;
@@ -129,7 +129,7 @@ typedef struct ei_matrix {
 
     ~ei_matrix() {
         if (buffer && buffer_managed_by_me) {
-            ei_free(buffer);
+            ei_dsp_scratch_free(buffer);
 
 #if EIDSP_TRACK_ALLOCATIONS
             if (_fn) {
@@ -156,19 +156,19 @@ typedef struct ei_matrix {
     }
 
     void* operator new(size_t size) {
-        return ei_malloc(size);
+        return ei_dsp_scratch_alloc(size, false);
     }
 
     void operator delete(void* ptr) {
-        ei_free(ptr);
+        ei_dsp_scratch_free(ptr);
     }
 
     void* operator new[](size_t size) {
-        return ei_malloc(size);
+        return ei_dsp_scratch_alloc(size, false);
     }
 
     void operator delete[](void* ptr) {
-        ei_free(ptr);
+        ei_dsp_scratch_free(ptr);
     }
 
     ei_matrix(ei_vector<float> &in) : ei_matrix(1, in.size(), in.data()) {
@@ -43,6 +43,37 @@
 namespace ei {
 namespace speechpy {
 
+/**
+ * Mel filterbank and DCT-II coefficients for one configuration, built on
+ * first use and kept until the configuration changes. Filter i is the sum
+ * of the power spectrum bin middle[i] (weight 1) and bins
+ * [start[i], start[i] + length[i]) weighted by weights + offset[i]; the
+ * middle bin's own entry there is 0.
+ */
+typedef struct {
+    uint32_t sampling_frequency;
+    uint16_t num_filters;
+    uint16_t fft_length;
+    uint32_t low_frequency;
+    uint32_t high_frequency;
+    uint16_t version;
+    uint16_t *middle;
+    uint16_t *start;
+    uint16_t *length;
+    uint16_t *offset;
+    float *weights;
+} mel_plan_t;
+
+/**
+ * Orthonormal DCT-II rows for the first num_cepstral coefficients of a
+ * num_filters long input (num_cepstral x num_filters, row major).
+ */
+typedef struct {
+    uint16_t num_filters;
+    uint16_t num_cepstral;
+    float *matrix;
+} dct_plan_t;
+
 class feature {
 public:
     /**
@@ -193,6 +224,163 @@ public:
         return static_cast<int>(floor((fft_size + 1) * hertz / sampling_freq));
     }
 
+    /**
+     * Get the mel filterbank plan for this configuration, building it if the
+     * cached one is for a different configuration. The plan lives on the
+     * heap (not in DSP scratch memory) so it survives between calls.
+     * low_frequency and high_frequency must already have their defaults
+     * applied.
+     * @returns the plan, or nullptr if out of memory
+     */
+    static const mel_plan_t *get_mel_plan(
+        uint32_t sampling_frequency, uint16_t num_filters, uint16_t fft_length,
+        uint32_t low_frequency, uint32_t high_frequency, uint16_t version)
+    {
+        static mel_plan_t plan = {};
+
+        if (plan.middle &&
+            plan.sampling_frequency == sampling_frequency && plan.num_filters == num_filters &&
+            plan.fft_length == fft_length && plan.low_frequency == low_frequency &&
+            plan.high_frequency == high_frequency && plan.version == version) {
+            return &plan;
+        }
+
+        if (plan.middle) {
+            ei_free(plan.middle);
+            plan.middle = nullptr;
+        }
+
+        const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
+
+        // the mel points, as bins (see mfe history for the quirks kept here)
+        const int MELS_SIZE = num_filters + 2;
+        ei_vector<float> mels(MELS_SIZE);
+        ei_vector<uint16_t> bins(MELS_SIZE);
+
+        numpy::linspace(
+            functions::frequency_to_mel(static_cast<float>(low_frequency)),
+            functions::frequency_to_mel(static_cast<float>(high_frequency)),
+            num_filters + 2,
+            mels.data());
+
+        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
+        // go to -1 size b/c special handling, see after
+        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
+            mels[ix] = functions::mel_to_frequency(mels[ix]);
+            if (mels[ix] < low_frequency) {
+                mels[ix] = low_frequency;
+            }
+            if (mels[ix] > high_frequency) {
+                mels[ix] = high_frequency;
+            }
+            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
+        }
+
+        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
+        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
+        // thus calculating the bucket to 64, not 65.
+        // we're adjusting this here a tiny bit to ensure we have the same result
+        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
+        if (mels[MELS_SIZE-1] > high_frequency) {
+            mels[MELS_SIZE-1] = high_frequency;
+        }
+        mels[MELS_SIZE-1] -= 0.001;
+        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
+
+        // both left and right have zero weight, so a filter spans (left, right)
+        size_t weight_count = 0;
+        for (size_t i = 0; i < num_filters; i++) {
+            if (bins[i+2] > bins[i]) {
+                weight_count += bins[i+2] - bins[i] - 1;
+            }
+        }
+
+        uint8_t *mem = (uint8_t*)ei_malloc(4 * num_filters * sizeof(uint16_t) + weight_count * sizeof(float));
+        if (!mem) {
+            return nullptr;
+        }
+        plan.middle = (uint16_t*)mem;
+        plan.start = plan.middle + num_filters;
+        plan.length = plan.start + num_filters;
+        plan.offset = plan.length + num_filters;
+        // 4 * num_filters uint16_t is a multiple of 8 bytes, so this stays aligned
+        plan.weights = (float*)(plan.offset + num_filters);
+
+        size_t offset = 0;
+        for (size_t i = 0; i < num_filters; i++) {
+            size_t left = bins[i];
+            size_t middle = bins[i+1];
+            size_t right = bins[i+2];
+
+            assert(right < power_spectrum_frame_size);
+
+            plan.middle[i] = middle;
+            plan.start[i] = left + 1;
+            plan.length[i] = right > left ? right - left - 1 : 0;
+            plan.offset[i] = offset;
+
+            for (size_t bin = left+1; bin < right; bin++) {
+                float weight = 0.0f; // middle is added separately, with weight 1
+                if (bin < middle) {
+                    weight = (static_cast<float>(bin) - left) / (middle - left);
+                }
+                if (bin > middle) {
+                    weight = (right - static_cast<float>(bin)) / (right - middle);
+                }
+                plan.weights[offset++] = weight;
+            }
+        }
+
+        plan.sampling_frequency = sampling_frequency;
+        plan.num_filters = num_filters;
+        plan.fft_length = fft_length;
+        plan.low_frequency = low_frequency;
+        plan.high_frequency = high_frequency;
+        plan.version = version;
+
+        return &plan;
+    }
+
+    /**
+     * Get the DCT-II plan (orthonormal, first num_cepstral coefficients) for
+     * a num_filters long input, building it if needed. Lives on the heap.
+     * @returns the plan, or nullptr if out of memory
+     */
+    static const dct_plan_t *get_dct_plan(uint16_t num_filters, uint16_t num_cepstral)
+    {
+        static dct_plan_t plan = {};
+
+        if (plan.matrix && plan.num_filters == num_filters && plan.num_cepstral == num_cepstral) {
+            return &plan;
+        }
+
+        if (plan.matrix) {
+            ei_free(plan.matrix);
+            plan.matrix = nullptr;
+        }
+
+        plan.matrix = (float*)ei_malloc(num_cepstral * num_filters * sizeof(float));
+        if (!plan.matrix) {
+            return nullptr;
+        }
+
+        // X[k] = s(k) * 2 * sum_n x[n] * cos(pi * k * (2n + 1) / 2N), with
+        // s(0) = sqrt(1 / 4N) and s(k) = sqrt(1 / 2N) otherwise
+        const double n_inv = 1.0 / static_cast<double>(num_filters);
+        for (size_t k = 0; k < num_cepstral; k++) {
+            double scale = 2.0 * sqrt((k == 0 ? 0.25 : 0.5) * n_inv);
+            for (size_t n = 0; n < num_filters; n++) {
+                plan.matrix[k * num_filters + n] = static_cast<float>(
+                    scale * cos(M_PI * k * (2 * n + 1) * 0.5 * n_inv));
+            }
+        }
+
+        plan.num_filters = num_filters;
+        plan.num_cepstral = num_cepstral;
+
+        return &plan;
+    }
+
     /**
      * Compute Mel-filterbank energy features from an audio signal.
      * @param out_features Use `calculate_mfe_buffer_size` to allocate the right matrix.
@@ -267,47 +455,11 @@ public:
         }
 
         const size_t power_spectrum_frame_size = (fft_length / 2 + 1);
-        // Computing the Mel filterbank
-        // converting the upper and lower frequencies to Mels.
-        // num_filter + 2 is because for num_filter filterbanks we need
-        // num_filter+2 point.
-        float *mels;
-        const int MELS_SIZE = num_filters + 2;
-        const size_t mem_size = MELS_SIZE * sizeof(float);
-        mels = (float*)ei_dsp_calloc(MELS_SIZE, sizeof(float));
-        EI_ERR_AND_RETURN_ON_NULL(mels, EIDSP_OUT_OF_MEM);
-        ei_unique_ptr_t __ptr__(mels,[mem_size](void* ptr){ei::ei_dsp_free_func(ptr, mem_size);});
-        uint16_t* bins = reinterpret_cast<uint16_t*>(mels); // alias the mels array so we can reuse the space
-
-        numpy::linspace(
-            functions::frequency_to_mel(static_cast<float>(low_frequency)),
-            functions::frequency_to_mel(static_cast<float>(high_frequency)),
-            num_filters + 2,
-            mels);
-
-        uint16_t max_bin = version >= 4 ? fft_length : power_spectrum_frame_size; // preserve a bug in v<4
-        // go to -1 size b/c special handling, see after
-        for (uint16_t ix = 0; ix < MELS_SIZE-1; ix++) {
-            mels[ix] = functions::mel_to_frequency(mels[ix]);
-            if (mels[ix] < low_frequency) {
-                mels[ix] = low_frequency;
-            }
-            if (mels[ix] > high_frequency) {
-                mels[ix] = high_frequency;
-            }
-            bins[ix] = get_fft_bin_from_hertz(max_bin, mels[ix], sampling_frequency);
-        }
 
-        // here is a really annoying bug in Speechpy which calculates the frequency index wrong for the last bucket
-        // the last 'hertz' value is not 8,000 (with sampling rate 16,000) but 7,999.999999
-        // thus calculating the bucket to 64, not 65.
-        // we're adjusting this here a tiny bit to ensure we have the same result
-        mels[MELS_SIZE-1] = functions::mel_to_frequency(mels[MELS_SIZE-1]);
-        if (mels[MELS_SIZE-1] > high_frequency) {
-            mels[MELS_SIZE-1] = high_frequency;
-        }
-        mels[MELS_SIZE-1] -= 0.001;
-        bins[MELS_SIZE-1] = get_fft_bin_from_hertz(max_bin, mels[MELS_SIZE-1], sampling_frequency);
+        // the filterbank only depends on the configuration, so it is built once
+        const mel_plan_t *plan = get_mel_plan(
+            sampling_frequency, num_filters, fft_length, low_frequency, high_frequency, version);
+        EI_ERR_AND_RETURN_ON_NULL(plan, EIDSP_OUT_OF_MEM);
 
         EI_DSP_MATRIX(power_spectrum_frame, 1, power_spectrum_frame_size);
         if (!power_spectrum_frame.buffer) {
@@ -358,31 +510,15 @@ public:
 
             auto row_ptr = out_features->get_row_ptr(ix);
             for (size_t i = 0; i < num_filters; i++) {
-                size_t left = bins[i];
-                size_t middle = bins[i+1];
-                size_t right = bins[i+2];
-
-                assert(right < power_spectrum_frame_size);
-                // now we have weights and locations to move from fft to mel sgram
-                // both left and right become zero weights, so skip them
-
-                // middle always has weight of 1.0
-                // since we skip left and right, if left = middle we need to handle that
-                row_ptr[i] = power_spectrum_frame.buffer[middle];
-
-                for (size_t bin = left+1; bin < right; bin++) {
-                    if (bin < middle) {
-                        row_ptr[i] +=
-                            ((static_cast<float>(bin) - left) / (middle - left)) * // weight *
-                            power_spectrum_frame.buffer[bin];
-                    }
-                    // intentionally skip middle, handled above
-                    if (bin > middle) {
-                        row_ptr[i] +=
-                            ((right - static_cast<float>(bin)) / (right - middle)) * // weight *
-                            power_spectrum_frame.buffer[bin];
-                    }
+                // only the non-zero span of the triangle is stored
+                const float *weights = plan->weights + plan->offset[i];
+                const float *spectrum = power_spectrum_frame.buffer + plan->start[i];
+
+                float sum = power_spectrum_frame.buffer[plan->middle[i]];
+                for (size_t bin = 0; bin < plan->length[i]; bin++) {
+                    sum += weights[bin] * spectrum[bin];
                 }
+                row_ptr[i] = sum;
             }
 
             if (ret != 0) {
@@ -762,23 +898,26 @@ public:
             EIDSP_ERR(ret);
         }
 
-        // now do DST type 2
-        ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
-        if (ret != EIDSP_OK) {
-            EIDSP_ERR(ret);
-        }
+        // now do DCT type 2, straight into the output; only the first
+        // num_cepstral coefficients are kept so only those are computed
+        const dct_plan_t *dct = get_dct_plan(num_filters, num_cepstral);
+        EI_ERR_AND_RETURN_ON_NULL(dct, EIDSP_OUT_OF_MEM);
 
-        // replace first cepstral coefficient with log of frame energy for DC elimination
-        if (dc_elimination) {
-            for (size_t row = 0; row < features_matrix.rows; row++) {
-                features_matrix.buffer[row * features_matrix.cols] = numpy::log(energy_matrix.buffer[row]);
+        for (size_t row = 0; row < features_matrix.rows; row++) {
+            const float *in = features_matrix.buffer + (features_matrix.cols * row);
+            float *out = out_features->buffer + (num_cepstral * row);
+            for (int i = 0; i < num_cepstral; i++) {
+                const float *coefficients = dct->matrix + (i * num_filters);
+                float sum = 0;
+                for (size_t n = 0; n < num_filters; n++) {
+                    sum += coefficients[n] * in[n];
+                }
+                out[i] = sum;
             }
-        }
 
-        // copy to the output...
-        for (size_t row = 0; row < features_matrix.rows; row++) {
-            for(int i = 0; i < num_cepstral; i++) {
-                *(out_features->buffer + (num_cepstral * row) + i) = *(features_matrix.buffer + (features_matrix.cols * row) + i);
+            // replace first cepstral coefficient with log of frame energy for DC elimination
+            if (dc_elimination) {
+                out[0] = numpy::log(energy_matrix.buffer[row]);
             }
         }
 
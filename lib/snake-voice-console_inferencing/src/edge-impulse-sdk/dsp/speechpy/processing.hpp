@@ -384,6 +384,23 @@ namespace processing {
         return numframes;
     }
 
+    /**
+     * Index into a vector of `size` elements extended on both sides with
+     * numpy's 'symmetric' padding (edges repeated, reflected as often as
+     * needed), the same layout numpy::pad_1d_symmetric produces.
+     * @param ix Index relative to the start of the unpadded vector
+     * @param size Length of the unpadded vector (> 0)
+     * @returns Index into the unpadded vector
+     */
+    static inline size_t symmetric_index(int32_t ix, size_t size) {
+        int32_t period = 2 * (int32_t)size;
+        int32_t m = ix % period;
+        if (m < 0) {
+            m += period;
+        }
+        return m < (int32_t)size ? m : period - 1 - m;
+    }
+
     /**
      * This function performs local cepstral mean and
      * variance normalization on a sliding window. The code assumes that
@@ -404,80 +421,89 @@ namespace processing {
             return EIDSP_OK;
         }
 
-        uint16_t pad_size = (win_size - 1) / 2;
+        const size_t rows = features_matrix->rows;
+        const size_t cols = features_matrix->cols;
+        const int32_t pad_size = (win_size - 1) / 2;
 
-        int ret;
-        float *features_buffer_ptr;
+        if (rows == 0) {
+            EIDSP_ERR(EIDSP_INPUT_MATRIX_EMPTY);
+        }
 
-        // mean & variance normalization
-        EI_DSP_MATRIX(vec_pad, features_matrix->rows + (pad_size * 2), features_matrix->cols);
-        if (!vec_pad.buffer) {
+        // The window for row ix covers rows ix - pad_size .. ix - pad_size +
+        // win_size - 1 of the input padded with numpy's 'symmetric' mode.
+        // Instead of materializing the padded matrix and re-summing the whole
+        // window for every row, keep running sums per column and move the
+        // window one row at a time: O(rows + win_size) per column instead of
+        // O(rows * win_size). Only one column of scratch is needed, as the
+        // output overwrites the input while later windows still read it.
+        // The sums are kept in double: in float, the residue left after a
+        // loud stretch leaves the window is amplified by 1e10 in a following
+        // silent (zero variance) stretch.
+        EI_DSP_MATRIX(column, 1, rows);
+        if (!column.buffer) {
             EIDSP_ERR(EIDSP_OUT_OF_MEM);
         }
 
-        ret = numpy::pad_1d_symmetric(features_matrix, &vec_pad, pad_size, pad_size);
-        if (ret != EIDSP_OK) {
-            EIDSP_ERR(ret);
-        }
+        const double inv_win = 1.0 / win_size;
 
-        EI_DSP_MATRIX(mean_matrix, vec_pad.cols, 1);
-        if (!mean_matrix.buffer) {
-            EIDSP_ERR(EIDSP_OUT_OF_MEM);
-        }
+        for (size_t col = 0; col < cols; col++) {
+            float *fm = features_matrix->buffer + col;
 
-        EI_DSP_MATRIX(window_variance, vec_pad.cols, 1);
-        if (!window_variance.buffer) {
-            return EIDSP_OUT_OF_MEM;
-        }
+            // mean normalization, over the original values
+            for (size_t ix = 0; ix < rows; ix++) {
+                column.buffer[ix] = fm[ix * cols];
+            }
 
-        for (size_t ix = 0; ix < features_matrix->rows; ix++) {
-            // create a slice on the vec_pad
-            EI_DSP_MATRIX_B(window, win_size, vec_pad.cols, vec_pad.buffer + (ix * vec_pad.cols));
-            if (!window.buffer) {
-                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            double sum = 0.0;
+            for (int32_t k = 0; k < win_size; k++) {
+                sum += column.buffer[symmetric_index(k - pad_size, rows)];
             }
 
-            ret = numpy::mean_axis0(&window, &mean_matrix);
-            if (ret != EIDSP_OK) {
-                EIDSP_ERR(ret);
+            for (size_t ix = 0; ix < rows; ix++) {
+                fm[ix * cols] = column.buffer[ix] - (float)(sum * inv_win);
+
+                int32_t first = (int32_t)ix - pad_size;
+                sum += (double)column.buffer[symmetric_index(first + win_size, rows)] -
+                       column.buffer[symmetric_index(first, rows)];
             }
 
-            // subtract the mean for the features
-            for (size_t fm_col = 0; fm_col < features_matrix->cols; fm_col++) {
-                features_matrix->buffer[(ix * features_matrix->cols) + fm_col] =
-                    features_matrix->buffer[(ix * features_matrix->cols) + fm_col] - mean_matrix.buffer[fm_col];
+            if (!variance_normalization) {
+                continue;
             }
-        }
 
-        ret = numpy::pad_1d_symmetric(features_matrix, &vec_pad, pad_size, pad_size);
-        if (ret != EIDSP_OK) {
-            EIDSP_ERR(ret);
-        }
+            // variance normalization, over the mean normalized values. The
+            // window's mean and sum of squared deviations are updated as one
+            // value leaves and one enters (no E[x^2] - E[x]^2 cancellation)
+            for (size_t ix = 0; ix < rows; ix++) {
+                column.buffer[ix] = fm[ix * cols];
+            }
 
-        for (size_t ix = 0; ix < features_matrix->rows; ix++) {
-            // create a slice on the vec_pad
-            EI_DSP_MATRIX_B(window, win_size, vec_pad.cols, vec_pad.buffer + (ix * vec_pad.cols));
-            if (!window.buffer) {
-                EIDSP_ERR(EIDSP_OUT_OF_MEM);
+            sum = 0.0;
+            for (int32_t k = 0; k < win_size; k++) {
+                sum += column.buffer[symmetric_index(k - pad_size, rows)];
+            }
+            double mean = sum * inv_win;
+            double m2 = 0.0;
+            for (int32_t k = 0; k < win_size; k++) {
+                double d = column.buffer[symmetric_index(k - pad_size, rows)] - mean;
+                m2 += d * d;
             }
 
-            if (variance_normalization == true) {
-                ret = numpy::std_axis0(&window, &window_variance);
-                if (ret != EIDSP_OK) {
-                    EIDSP_ERR(ret);
-                }
+            for (size_t ix = 0; ix < rows; ix++) {
+                float var = m2 > 0.0 ? (float)(m2 * inv_win) : 0.0f;
+                fm[ix * cols] = column.buffer[ix] / (sqrt(var) + 1e-10);
 
-                features_buffer_ptr = &features_matrix->buffer[ix * vec_pad.cols];
-                for (size_t col = 0; col < vec_pad.cols; col++) {
-                    *(features_buffer_ptr) = (*(features_buffer_ptr)) /
-                                             (window_variance.buffer[col] + 1e-10);
-                    features_buffer_ptr++;
-                }
+                int32_t first = (int32_t)ix - pad_size;
+                double v_in = column.buffer[symmetric_index(first + win_size, rows)];
+                double v_out = column.buffer[symmetric_index(first, rows)];
+                double new_mean = mean + (v_in - v_out) * inv_win;
+                m2 += (v_in - v_out) * (v_in - new_mean + v_out - mean);
+                mean = new_mean;
             }
         }
 
         if (scale) {
-            ret = numpy::normalize(features_matrix);
+            int ret = numpy::normalize(features_matrix);
             if (ret != EIDSP_OK) {
                 EIDSP_ERR(ret);
             }
@@ -0,0 +1,53 @@
+#ifndef GAME_EVENTS_H
+#define GAME_EVENTS_H
+
+#include <stdint.h>
+
+// What a playfield cell now shows
+enum CellKind : uint8_t
+{
+  CELL_EMPTY,
+  CELL_FOOD,
+  CELL_HEAD,
+  CELL_BODY
+};
+
+enum SoundEvent : uint8_t
+{
+  SOUND_EAT,
+  SOUND_GAME_OVER
+};
+
+enum GameOverReason : uint8_t
+{
+  OVER_WALL,
+  OVER_SELF
+};
+
+// Output side of the game core. The core never draws or beeps itself; it
+// reports what changed and the platform decides how to show it (TFT +
+// buzzer on the device, nothing at all in the headless simulator).
+class GameEvents
+{
+public:
+  virtual ~GameEvents() {}
+
+  // A single cell changed. dir is the direction of travel for head/body
+  // cells (0=Up,1=Right,2=Down,3=Left), 0 otherwise.
+  virtual void on_cell(uint8_t gx, uint8_t gy, CellKind kind, uint8_t dir) = 0;
+  virtual void on_sound(SoundEvent sound) = 0;
+  virtual void on_score(int score, int level, int speed) = 0;
+  virtual void on_game_over(GameOverReason why) = 0;
+};
+
+// Sink that ignores everything, for benchmarks and headless runs
+class NullGameEvents : public GameEvents
+{
+public:
+  void on_cell(uint8_t, uint8_t, CellKind, uint8_t) override {}
+  void on_sound(SoundEvent) override {}
+  void on_score(int, int, int) override {}
+  void on_game_over(GameOverReason) override {}
+};
+
+#endif // GAME_EVENTS_H
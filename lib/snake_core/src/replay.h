@@ -0,0 +1,318 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Compact binary replays: a game's seed plus every input it received, keyed
+// by game tick. Since the core is deterministic from its seed, re-applying
+// the inputs at the same ticks reproduces the game exactly.
+//
+// Record layout (little endian):
+//   'S' 'R' version flags seed[4] payload_len[2] summary payload...
+// where the summary (version 2 on, absent in version 1 records) is
+//   final_score[2] final_length[2] final_tick[4]
+// as written by ReplayRecorder::finish(), so a re-simulation can be checked.
+// Each payload event is one byte
+//   bits 7..6 type, bits 5..4 arg, bits 3..0 tick delta (0..14)
+// with delta 15 meaning "LEB128 varint of (delta - 15) follows". Typical
+// games cost one or two bytes per input.
+
+enum ReplayEventType : uint8_t
+{
+  REPLAY_TURN = 0,    // arg = direction, as queued (validated at the tick)
+  REPLAY_PAUSE = 1,   // pause toggle
+  REPLAY_RESTART = 2, // game abandoned by a restart
+  REPLAY_END = 3      // game over (last event)
+};
+
+constexpr uint8_t REPLAY_MAGIC0 = 'S';
+constexpr uint8_t REPLAY_MAGIC1 = 'R';
+constexpr uint8_t REPLAY_VERSION = 2;
+constexpr uint8_t REPLAY_VERSION_NO_SUMMARY = 1; // still readable
+constexpr uint8_t REPLAY_FLAG_TRUNCATED = 0x01;
+constexpr size_t REPLAY_HEADER_SIZE = 10; // enough for ReplayReader::record_size()
+constexpr size_t REPLAY_SUMMARY_SIZE = 8;
+
+struct ReplayEvent
+{
+  uint32_t tick;
+  ReplayEventType type;
+  uint8_t arg;
+};
+
+// Collects one game's replay into a fixed buffer of CAP bytes. When the
+// buffer runs out the replay is marked truncated and further events are
+// dropped; the player stops at that point.
+template <size_t CAP>
+class ReplayRecorder
+{
+public:
+  void begin(uint32_t seed)
+  {
+    buf[0] = REPLAY_MAGIC0;
+    buf[1] = REPLAY_MAGIC1;
+    buf[2] = REPLAY_VERSION;
+    buf[3] = 0;
+    put_le(4, seed, 4);
+    for (size_t i = 0; i < REPLAY_SUMMARY_SIZE; i++)
+      buf[REPLAY_HEADER_SIZE + i] = 0; // filled in by finish()
+    len = PAYLOAD_START;
+    last_tick = 0;
+    active = true;
+    finished = false;
+    set_payload_len();
+  }
+
+  bool is_active() const { return active; }
+
+  bool record(uint32_t tick, ReplayEventType type, uint8_t arg = 0)
+  {
+    if (!active || finished)
+      return false;
+
+    uint32_t delta = tick - last_tick;
+    uint8_t tmp[6];
+    size_t n = 0;
+    uint8_t head = (type << 6) | ((arg & 3) << 4);
+    if (delta < 15)
+      tmp[n++] = head | delta;
+    else
+    {
+      tmp[n++] = head | 15;
+      uint32_t v = delta - 15;
+      do
+      {
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        tmp[n++] = b | (v ? 0x80 : 0);
+      } while (v);
+    }
+
+    if (len + n > CAP)
+    {
+      buf[3] |= REPLAY_FLAG_TRUNCATED;
+      finished = true;
+      return false;
+    }
+    for (size_t i = 0; i < n; i++)
+      buf[len++] = tmp[i];
+    last_tick = tick;
+    set_payload_len();
+    return true;
+  }
+
+  // Close the replay with a RESTART or END event and the game's final
+  // score and length; data()/size() are then final
+  void finish(uint32_t tick, ReplayEventType type, uint16_t score, uint16_t length)
+  {
+    record(tick, type);
+    put_le(REPLAY_HEADER_SIZE, score, 2);
+    put_le(REPLAY_HEADER_SIZE + 2, length, 2);
+    put_le(REPLAY_HEADER_SIZE + 4, tick, 4);
+    finished = true;
+    active = false;
+  }
+
+  const uint8_t *data() const { return buf; }
+  size_t size() const { return len; }
+
+private:
+  static constexpr size_t PAYLOAD_START = REPLAY_HEADER_SIZE + REPLAY_SUMMARY_SIZE;
+  static_assert(CAP > PAYLOAD_START, "replay buffer smaller than its header");
+
+  uint8_t buf[CAP];
+  size_t len = 0;
+  uint32_t last_tick = 0;
+  bool active = false;
+  bool finished = false;
+
+  void put_le(size_t at, uint32_t v, size_t bytes)
+  {
+    for (size_t i = 0; i < bytes; i++)
+      buf[at + i] = (v >> (8 * i)) & 0xFF;
+  }
+
+  void set_payload_len() { put_le(8, len - PAYLOAD_START, 2); }
+};
+
+// Decodes one replay record from memory
+class ReplayReader
+{
+public:
+  ReplayReader() : p(nullptr), end(nullptr) {}
+
+  ReplayReader(const uint8_t *data, size_t size) : p(data), end(data + size)
+  {
+    size_t header = size < REPLAY_HEADER_SIZE ? 0 : header_size(data);
+    if (header == 0 || header > size)
+    {
+      p = end;
+      return;
+    }
+    flags = data[3];
+    seed = get_le(data + 4, 4);
+    size_t payload = get_le(data + 8, 2);
+    if (header + payload > size)
+    {
+      p = end;
+      return;
+    }
+    if (header > REPLAY_HEADER_SIZE)
+    {
+      summary = true;
+      score = get_le(data + REPLAY_HEADER_SIZE, 2);
+      length = get_le(data + REPLAY_HEADER_SIZE + 2, 2);
+      last_tick = get_le(data + REPLAY_HEADER_SIZE + 4, 4);
+    }
+    valid = true;
+    p = data + header;
+    end = p + payload;
+  }
+
+  // Size of a record from its first REPLAY_HEADER_SIZE bytes, or 0 if they
+  // are not a replay header
+  static size_t record_size(const uint8_t *hdr)
+  {
+    size_t header = header_size(hdr);
+    return header ? header + get_le(hdr + 8, 2) : 0;
+  }
+
+  bool ok() const { return valid; }
+  bool truncated() const { return flags & REPLAY_FLAG_TRUNCATED; }
+  uint32_t game_seed() const { return seed; }
+
+  // How the recorded game ended; only present from version 2
+  bool has_summary() const { return summary; }
+  uint16_t final_score() const { return score; }
+  uint16_t final_length() const { return length; }
+  uint32_t final_tick() const { return last_tick; }
+
+  bool next(ReplayEvent &ev)
+  {
+    if (p >= end)
+      return false;
+    uint8_t head = *p++;
+    uint32_t delta = head & 0x0F;
+    if (delta == 15)
+    {
+      uint32_t v = 0;
+      uint8_t shift = 0;
+      uint8_t b;
+      do
+      {
+        if (p >= end || shift > 28)
+          return false;
+        b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      delta = 15 + v;
+    }
+    tick += delta;
+    ev.tick = tick;
+    ev.type = (ReplayEventType)(head >> 6);
+    ev.arg = (head >> 4) & 3;
+    return true;
+  }
+
+private:
+  const uint8_t *p;
+  const uint8_t *end;
+  uint32_t seed = 0;
+  uint32_t tick = 0;
+  uint8_t flags = 0;
+  bool valid = false;
+  bool summary = false;
+  uint16_t score = 0;
+  uint16_t length = 0;
+  uint32_t last_tick = 0;
+
+  static uint32_t get_le(const uint8_t *b, size_t bytes)
+  {
+    uint32_t v = 0;
+    for (size_t i = 0; i < bytes; i++)
+      v |= (uint32_t)b[i] << (8 * i);
+    return v;
+  }
+
+  // Header plus summary size for a known version, 0 otherwise
+  static size_t header_size(const uint8_t *hdr)
+  {
+    if (hdr[0] != REPLAY_MAGIC0 || hdr[1] != REPLAY_MAGIC1)
+      return 0;
+    if (hdr[2] == REPLAY_VERSION)
+      return REPLAY_HEADER_SIZE + REPLAY_SUMMARY_SIZE;
+    if (hdr[2] == REPLAY_VERSION_NO_SUMMARY)
+      return REPLAY_HEADER_SIZE;
+    return 0;
+  }
+};
+
+// Re-simulates a replay on any SnakeGame instantiation. Call tick() once per
+// game tick: it applies the inputs recorded for that tick, steps the game and
+// spawns food, exactly like the live loop. Rendering follows whatever
+// GameEvents sink the game has, so the same player drives the TFT at
+// wall-clock speed on the device and runs unthrottled on the host.
+//
+// Pauses are recorded but never stall playback: ticks do not advance while
+// a live game is paused, so they cannot change the outcome.
+template <class GameT>
+class ReplayPlayer
+{
+public:
+  explicit ReplayPlayer(GameT &g) : game(g) {}
+
+  // data must stay valid while the replay plays
+  bool load(const uint8_t *data, size_t size)
+  {
+    reader = ReplayReader(data, size);
+    running = false;
+    if (!reader.ok())
+      return false;
+    game.reset(reader.game_seed());
+    game.spawn_food();
+    have_next = reader.next(pending);
+    running = true;
+    return true;
+  }
+
+  void stop() { running = false; }
+  bool is_running() const { return running; }
+
+  // Returns false once the replay has ended (game over, restart or end of data)
+  bool tick()
+  {
+    if (!running)
+      return false;
+
+    while (have_next && pending.tick == game.tick)
+    {
+      if (pending.type == REPLAY_TURN)
+        game.queue_turn(pending.arg);
+      else if (pending.type == REPLAY_RESTART)
+        return running = false;
+      have_next = reader.next(pending);
+    }
+
+    // A truncated replay has no inputs past its end; stop rather than guess
+    if (!have_next && reader.truncated())
+      return running = false;
+
+    game.step();
+    if (game.game_over)
+      return running = false;
+    if (game.food_eaten)
+      game.spawn_food();
+    return true;
+  }
+
+private:
+  GameT &game;
+  ReplayReader reader;
+  ReplayEvent pending = {0, REPLAY_TURN, 0};
+  bool have_next = false;
+  bool running = false;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,70 @@
+#ifndef RLE565_H
+#define RLE565_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Streaming decoder for the run-length encoded RGB565 images made by
+// tools/build_splash.py. Pixels stay big-endian (panel byte order), so
+// literal packets are a plain copy and every burst can go to the panel
+// without byte swapping.
+//
+// Packets: control byte c >= 0x80 is (c & 0x7F) + 1 copies of the next
+// pixel, c < 0x80 is c + 1 literal pixels. buf holds buf_px pixels
+// (2 * buf_px bytes); flush(buf, n) is called with each full buffer and
+// the final partial one. Returns the number of pixels decoded; a truncated
+// stream stops at the last whole packet.
+template <class Flush>
+size_t rle565_decode(const uint8_t *data, size_t size, uint8_t *buf, size_t buf_px, Flush flush)
+{
+  const uint8_t *p = data;
+  const uint8_t *end = data + size;
+  size_t fill = 0;
+  size_t total = 0;
+
+  while (p < end)
+  {
+    uint8_t c = *p++;
+    size_t count = (c & 0x7F) + 1;
+    bool run = c & 0x80;
+    if (p + (run ? 2 : 2 * count) > end)
+      break;
+
+    while (count > 0)
+    {
+      size_t n = buf_px - fill;
+      if (n > count)
+        n = count;
+      uint8_t *dst = buf + 2 * fill;
+      if (run)
+      {
+        for (size_t i = 0; i < n; i++)
+        {
+          dst[2 * i] = p[0];
+          dst[2 * i + 1] = p[1];
+        }
+      }
+      else
+      {
+        memcpy(dst, p, 2 * n);
+        p += 2 * n;
+      }
+      fill += n;
+      count -= n;
+      total += n;
+      if (fill == buf_px)
+      {
+        flush(buf, fill);
+        fill = 0;
+      }
+    }
+    if (run)
+      p += 2;
+  }
+  if (fill > 0)
+    flush(buf, fill);
+  return total;
+}
+
+#endif // RLE565_H
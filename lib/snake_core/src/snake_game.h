@@ -0,0 +1,391 @@
+#ifndef SNAKE_GAME_H
+#define SNAKE_GAME_H
+
+#include <stdint.h>
+#include <string.h>
+#include "game_events.h"
+#include "snake_rng.h"
+
+// Per-direction cell deltas, indexed by direction (0=Up,1=Right,2=Down,3=Left)
+constexpr int8_t DIR_DX[4] = {0, 1, 0, -1};
+constexpr int8_t DIR_DY[4] = {-1, 0, 1, 0};
+
+enum StepResult : uint8_t
+{
+  STEP_MOVED,    // head advanced, tail followed
+  STEP_ATE,      // head advanced onto the food
+  STEP_HIT_WALL,
+  STEP_HIT_SELF
+};
+
+// Pixel offsets of each column/row relative to the playfield origin, built at
+// compile time so drawing never multiplies by the cell size.
+template <uint8_t N, uint8_t CELL_PX>
+struct CellPixelTable
+{
+  uint16_t px[N];
+
+  constexpr CellPixelTable() : px()
+  {
+    for (uint8_t i = 0; i < N; i++)
+      px[i] = (uint16_t)i * CELL_PX;
+  }
+
+  constexpr uint16_t operator[](uint8_t i) const { return px[i]; }
+};
+
+// Game state and step logic for a GW x GH grid of CELL_PX pixel cells.
+// Every bound and buffer size is a compile-time constant, so each panel
+// variant gets exactly sized storage and constant-folded bounds checks.
+//
+// The body is a chain of 2-bit moves rather than coordinates: link k is the
+// direction that leads from segment k+1 to segment k. Links live in a ring of
+// MAX_LEN entries packed four per byte, link 0 at link_head. Only the head and
+// tail cells are stored explicitly; BodyIter recovers the rest.
+//
+// Alongside the chain the game keeps an occupancy bitmap (one bit per cell)
+// and a free-cell index (dense list of empty cells plus reverse map), both
+// updated in O(1) on head insert and tail removal.
+//
+// The core has no platform dependencies: cell changes, sounds and game over
+// are reported through the GameEvents sink given to set_events().
+template <uint8_t GW, uint8_t GH, uint8_t CELL_PX>
+class SnakeGame
+{
+public:
+  static constexpr uint8_t GRID_W = GW;
+  static constexpr uint8_t GRID_H = GH;
+  static constexpr uint8_t CELL_SIZE = CELL_PX;
+  static constexpr uint16_t CELLS = (uint16_t)GW * GH;
+  static constexpr uint16_t MAX_LEN = CELLS;
+  static constexpr uint16_t LINK_BYTES = (MAX_LEN + 3) / 4;
+  static constexpr uint16_t OCC_BYTES = (CELLS + 7) / 8;
+  static constexpr uint16_t START_LEN = 3;
+
+  static constexpr uint8_t TURN_QUEUE = 4; // pending turns buffered between ticks
+  static constexpr uint8_t NO_FOOD = 0xFF;  // food_x/food_y before the first spawn (off-grid)
+  static_assert(GW < NO_FOOD && GH < NO_FOOD, "NO_FOOD must lie outside the grid");
+
+  static constexpr int BASE_SPEED = 440; // ms per tick at level 1
+  static constexpr int SPEED_STEP = 12;  // ms faster per level
+  static constexpr int MIN_SPEED = 70;
+
+  static constexpr CellPixelTable<GW, CELL_PX> col_px{};
+  static constexpr CellPixelTable<GH, CELL_PX> row_px{};
+
+  uint8_t body_links[LINK_BYTES];
+  uint16_t link_head = 0;
+  uint8_t head_x = 0, head_y = 0;
+  uint8_t tail_x = 0, tail_y = 0;
+  uint16_t snake_len = START_LEN;
+  int8_t direction = 1; // last applied move: 0=Up,1=Right,2=Down,3=Left
+  bool food_eaten = true;
+  uint8_t food_x = NO_FOOD, food_y = NO_FOOD;
+  bool game_over = false;
+  bool paused = false;
+  int score = 0;
+  int level = 1;
+  int snake_speed = BASE_SPEED;
+
+  uint8_t occupancy[OCC_BYTES];
+
+  // Game randomness (food placement, start direction) comes only from rng,
+  // seeded in reset(), so a run is bit-exact from its seed.
+  uint32_t seed = 0;
+  SnakeRng rng;
+
+  // Completed step() calls since reset(); replays key their inputs on this
+  uint32_t tick = 0;
+
+  void set_events(GameEvents *sink) { events = sink ? sink : &null_events(); }
+
+  // Walks the body head to tail:
+  //   for (auto it = game.body(); !it.done(); it.next()) draw(it.x, it.y);
+  // dir is the move that entered the current segment (the head's is the last move).
+  struct BodyIter
+  {
+    const SnakeGame &g;
+    uint8_t x, y;
+    uint8_t dir;
+    uint16_t remaining;
+    uint16_t link;
+
+    explicit BodyIter(const SnakeGame &game)
+        : g(game), x(game.head_x), y(game.head_y), dir(game.direction),
+          remaining(game.snake_len), link(game.link_head) {}
+
+    bool done() const { return remaining == 0; }
+    bool is_head() const { return remaining == g.snake_len; }
+
+    void next()
+    {
+      if (--remaining == 0)
+        return;
+      dir = g.link_dir(link);
+      x -= DIR_DX[dir];
+      y -= DIR_DY[dir];
+      if (++link == MAX_LEN)
+        link = 0;
+    }
+  };
+
+  BodyIter body() const { return BodyIter(*this); }
+
+  static constexpr uint16_t cell_index(uint8_t gx, uint8_t gy) { return (uint16_t)gy * GW + gx; }
+
+  // Unsigned compare folds the < 0 and >= size tests into one each
+  static constexpr bool in_bounds(int gx, int gy)
+  {
+    return ((unsigned)gx < GW) & ((unsigned)gy < GH);
+  }
+
+  bool cell_occupied(uint8_t gx, uint8_t gy) const
+  {
+    uint16_t c = cell_index(gx, gy);
+    return occupancy[c >> 3] & (1 << (c & 7));
+  }
+
+  uint8_t link_dir(uint16_t idx) const
+  {
+    return (body_links[idx >> 2] >> ((idx & 3) * 2)) & 3;
+  }
+
+  uint16_t free_cell_count() const { return free_count; }
+
+  // Queue a turn for upcoming ticks. Each step() applies at most one turn,
+  // validated against the last *applied* direction (reversals and no-op turns
+  // are discarded), and leaves the rest queued for later ticks. UP then LEFT
+  // within one tick while moving RIGHT therefore makes a U-turn over two
+  // ticks instead of losing the UP. Returns false if the queue is full.
+  bool queue_turn(int8_t dir)
+  {
+    if (turn_count == TURN_QUEUE)
+      return false;
+    uint8_t tail = turn_head + turn_count;
+    if (tail >= TURN_QUEUE)
+      tail -= TURN_QUEUE;
+    turns[tail] = dir & 3;
+    turn_count++;
+    return true;
+  }
+
+  uint8_t pending_turns() const { return turn_count; }
+
+  // Reseed, lay out a START_LEN body horizontally in the middle of the grid
+  // (tail to the left of the head) and clear score/level/speed. The start
+  // direction is random but never Left, which would run into the body.
+  void reset(uint32_t game_seed)
+  {
+    seed = game_seed;
+    rng.seed(game_seed);
+    tick = 0;
+    snake_len = START_LEN;
+    score = 0;
+    level = 1;
+    snake_speed = BASE_SPEED;
+    direction = rng.below(3); // Up, Right or Down
+    turn_count = 0;
+
+    uint8_t hx = GW / 2;
+    uint8_t hy = GH / 2;
+    reset_cells();
+    link_head = 0;
+    head_x = hx;
+    head_y = hy;
+    tail_x = hx - (snake_len - 1);
+    tail_y = hy;
+    for (uint16_t i = 0; i < snake_len; i++)
+    {
+      if (i < snake_len - 1)
+        set_link(i, 1); // each segment was entered moving Right
+      occupy_cell(hx - i, hy);
+      events->on_cell(hx - i, hy, i == 0 ? CELL_HEAD : CELL_BODY, 1);
+    }
+
+    game_over = false;
+    paused = false;
+    food_eaten = true;
+    food_x = NO_FOOD; // the last game's food is gone until spawn_food()
+    food_y = NO_FOOD;
+  }
+
+  // Place food on a uniformly random free cell in O(1). The free-cell index
+  // never contains snake cells, so there is no retry loop. Returns false on
+  // a full board.
+  bool spawn_food()
+  {
+    if (free_count == 0)
+      return false;
+    uint16_t c = free_cells[rng.below(free_count)];
+    food_x = c % GW;
+    food_y = c / GW;
+    food_eaten = false;
+    events->on_cell(food_x, food_y, CELL_FOOD, 0);
+    return true;
+  }
+
+  // Apply the next valid queued turn, then advance one tick. O(1): push the
+  // move at the head end of the chain and, unless growing, pop the oldest
+  // link to advance the tail. Changed cells are reported tail, head, neck.
+  StepResult step()
+  {
+    tick++;
+    apply_queued_turn();
+
+    uint8_t old_head_x = head_x;
+    uint8_t old_head_y = head_y;
+
+    int next_x = head_x + DIR_DX[direction];
+    int next_y = head_y + DIR_DY[direction];
+
+    if (!in_bounds(next_x, next_y))
+      return end_game(OVER_WALL);
+
+    // eaten (or not yet spawned) food can't be eaten again
+    bool willGrow = !food_eaten && next_x == food_x && next_y == food_y;
+
+    // moving into the current tail cell is allowed if we are NOT growing,
+    // because the tail will move away this tick.
+    bool intoTail = (next_x == tail_x && next_y == tail_y);
+    if (cell_occupied(next_x, next_y) && (willGrow || !intoTail))
+      return end_game(OVER_SELF);
+
+    // Growing keeps the old tail as the last segment; otherwise the tail
+    // follows the oldest link and leaves its cell
+    bool grows = willGrow && snake_len < MAX_LEN;
+    if (!grows)
+    {
+      release_cell(tail_x, tail_y);
+      if (!intoTail)
+        events->on_cell(tail_x, tail_y, CELL_EMPTY, 0);
+      if (snake_len > 1)
+      {
+        uint16_t last = link_head + snake_len - 2;
+        if (last >= MAX_LEN)
+          last -= MAX_LEN;
+        uint8_t d = link_dir(last);
+        tail_x += DIR_DX[d];
+        tail_y += DIR_DY[d];
+      }
+    }
+
+    // Push the move as the newest link, one slot before the old one
+    link_head = (link_head == 0) ? MAX_LEN - 1 : link_head - 1;
+    set_link(link_head, direction);
+    head_x = next_x;
+    head_y = next_y;
+    occupy_cell(next_x, next_y);
+
+    if (grows)
+      ++snake_len;
+    else if (snake_len == 1)
+    {
+      tail_x = head_x;
+      tail_y = head_y;
+    }
+
+    events->on_cell(head_x, head_y, CELL_HEAD, direction);
+    if (snake_len > 1)
+      events->on_cell(old_head_x, old_head_y, CELL_BODY, direction);
+
+    if (!willGrow)
+      return STEP_MOVED;
+
+    // Update score/level/speed
+    food_eaten = true;
+    score++;
+    level = score / 3 + 1;
+    int speed = BASE_SPEED - (level - 1) * SPEED_STEP;
+    snake_speed = speed < MIN_SPEED ? MIN_SPEED : speed;
+    events->on_sound(SOUND_EAT);
+    events->on_score(score, level, snake_speed);
+    return STEP_ATE;
+  }
+
+private:
+  GameEvents *events = &null_events();
+
+  uint8_t turns[TURN_QUEUE];
+  uint8_t turn_head = 0;
+  uint8_t turn_count = 0;
+
+  // Reversals are judged against the head's first body link, the move that
+  // actually laid the neck. That equals direction after any step, but not
+  // before the first one: the start body always points Right.
+  void apply_queued_turn()
+  {
+    const uint8_t back = (link_dir(link_head) + 2) & 3;
+    while (turn_count > 0)
+    {
+      uint8_t dir = turns[turn_head];
+      if (++turn_head == TURN_QUEUE)
+        turn_head = 0;
+      turn_count--;
+      if (dir != direction && dir != back)
+      {
+        direction = dir;
+        return;
+      }
+    }
+  }
+
+  // Free-cell index: free_cells[0 .. free_count) lists every cell not under the
+  // snake (in no particular order), free_slot[c] is where cell c sits in that list.
+  uint16_t free_cells[CELLS];
+  uint16_t free_slot[CELLS];
+  uint16_t free_count = 0;
+
+  void occupy_cell(uint8_t gx, uint8_t gy)
+  {
+    uint16_t c = cell_index(gx, gy);
+    occupancy[c >> 3] |= (1 << (c & 7));
+
+    uint16_t slot = free_slot[c];
+    uint16_t last = free_cells[--free_count];
+    free_cells[slot] = last;
+    free_slot[last] = slot;
+  }
+
+  void release_cell(uint8_t gx, uint8_t gy)
+  {
+    uint16_t c = cell_index(gx, gy);
+    occupancy[c >> 3] &= ~(1 << (c & 7));
+
+    free_cells[free_count] = c;
+    free_slot[c] = free_count++;
+  }
+
+  // Clear the board: every cell free, nothing occupied
+  void reset_cells()
+  {
+    memset(occupancy, 0, sizeof(occupancy));
+    for (uint16_t c = 0; c < CELLS; c++)
+    {
+      free_cells[c] = c;
+      free_slot[c] = c;
+    }
+    free_count = CELLS;
+  }
+
+  static GameEvents &null_events()
+  {
+    static NullGameEvents sink;
+    return sink;
+  }
+
+  StepResult end_game(GameOverReason why)
+  {
+    game_over = true;
+    events->on_sound(SOUND_GAME_OVER);
+    events->on_game_over(why);
+    return why == OVER_WALL ? STEP_HIT_WALL : STEP_HIT_SELF;
+  }
+
+  void set_link(uint16_t idx, uint8_t dir)
+  {
+    uint8_t shift = (idx & 3) * 2;
+    body_links[idx >> 2] = (body_links[idx >> 2] & ~(3 << shift)) | (dir << shift);
+  }
+};
+
+#endif // SNAKE_GAME_H
@@ -0,0 +1,33 @@
+#ifndef SNAKE_RNG_H
+#define SNAKE_RNG_H
+
+#include <stdint.h>
+
+// Small seedable PRNG (xorshift32) for game logic. The same seed always gives
+// the same sequence on every platform, so a game is reproducible from its
+// seed plus its inputs.
+class SnakeRng
+{
+public:
+  explicit SnakeRng(uint32_t s = 1) { seed(s); }
+
+  // xorshift has a single all-zero fixed point; map seed 0 to a fixed constant
+  void seed(uint32_t s) { state = s ? s : 0x9E3779B9u; }
+
+  uint32_t next()
+  {
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return state = x;
+  }
+
+  // Uniform value in [0, n) by multiply-shift, no division
+  uint32_t below(uint32_t n) { return (uint32_t)(((uint64_t)next() * n) >> 32); }
+
+private:
+  uint32_t state;
+};
+
+#endif // SNAKE_RNG_H
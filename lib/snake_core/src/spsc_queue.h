@@ -0,0 +1,57 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Fixed-capacity lock-free single-producer/single-consumer ring. One task
+// may push and one (other) task may pop, concurrently, without locks: the
+// producer owns head, the consumer owns tail, and each publishes its index
+// with release ordering after touching the slot. Counters run freely and
+// wrap; N must be a power of two so the wrap stays consistent.
+template <typename T, size_t N>
+class SpscQueue
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+  // Producer side. Returns false (and drops v) when full.
+  bool push(const T &v)
+  {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (h - t == N)
+      return false;
+    buf[h & (N - 1)] = v;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false when empty.
+  bool pop(T &out)
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (h == t)
+      return false;
+    out = buf[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate from either side; exact from the consumer when it is empty
+  bool empty() const
+  {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() { return N; }
+
+private:
+  T buf[N];
+  std::atomic<uint32_t> head{0};
+  std::atomic<uint32_t> tail{0};
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,56 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <stdint.h>
+
+// Start a long-running task pinned to a core. On the ESP32 this is a FreeRTOS
+// task (xTaskCreatePinnedToCore; fn must never return). On the host it is a
+// std::thread, with core and priority ignored, so the same task split and
+// queue handoffs can be exercised by the native build; join_tasks() waits
+// for all of them once they have been told to stop.
+typedef void (*TaskFn)(void *arg);
+
+#if defined(ESP_PLATFORM)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+inline bool start_pinned_task(const char *name, TaskFn fn, void *arg,
+                              uint32_t stack_bytes, uint8_t priority, int core)
+{
+  return xTaskCreatePinnedToCore(fn, name, stack_bytes, arg, priority, nullptr, core) == pdPASS;
+}
+
+inline void task_sleep_ms(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms) ? pdMS_TO_TICKS(ms) : 1); }
+
+#else
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+inline std::vector<std::thread> &host_tasks()
+{
+  static std::vector<std::thread> tasks;
+  return tasks;
+}
+
+inline bool start_pinned_task(const char *, TaskFn fn, void *arg,
+                              uint32_t, uint8_t, int)
+{
+  host_tasks().emplace_back(fn, arg);
+  return true;
+}
+
+inline void join_tasks()
+{
+  for (auto &t : host_tasks())
+    t.join();
+  host_tasks().clear();
+}
+
+inline void task_sleep_ms(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+#endif
+
+#endif // TASKS_H
@@ -0,0 +1,73 @@
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <stdint.h>
+
+// Fixed-timestep tick scheduler. Deadlines advance by exactly one period per
+// tick, independent of when the loop got around to polling, so time lost to
+// blocking calls is caught up on the next poll instead of stretching the
+// cadence. Catch-up is capped per poll; anything further behind is dropped
+// and counted rather than fast-forwarded.
+//
+// Times are in milliseconds from any monotonic clock (millis() on device).
+class TickScheduler
+{
+public:
+  static constexpr uint8_t MAX_CATCHUP = 3;
+
+  struct Stats
+  {
+    uint32_t ticks = 0;     // ticks issued
+    uint32_t late_sum = 0;  // total lateness vs deadline, ms
+    uint32_t late_max = 0;  // worst lateness, ms
+    uint32_t dropped = 0;   // ticks skipped beyond MAX_CATCHUP
+  };
+
+  // (Re)arm: first tick one period from now. Call on start, resume and
+  // restart so paused time is not caught up.
+  void start(uint32_t now, uint32_t period)
+  {
+    next_due = now + period;
+  }
+
+  // Ticks due at now (0..MAX_CATCHUP). period applies to deadlines scheduled
+  // from here on, so speed changes take effect on the next tick.
+  uint8_t poll(uint32_t now, uint32_t period)
+  {
+    uint8_t n = 0;
+    while ((int32_t)(now - next_due) >= 0)
+    {
+      if (n == MAX_CATCHUP)
+      {
+        // too far behind: drop the backlog and restart the cadence from now
+        uint32_t behind = (now - next_due) / period + 1;
+        stats.dropped += behind;
+        next_due = now + period;
+        break;
+      }
+      uint32_t late = now - next_due;
+      stats.late_sum += late;
+      if (late > stats.late_max)
+        stats.late_max = late;
+      stats.ticks++;
+      next_due += period;
+      n++;
+    }
+    return n;
+  }
+
+  uint32_t ms_until_next(uint32_t now) const
+  {
+    int32_t d = (int32_t)(next_due - now);
+    return d > 0 ? (uint32_t)d : 0;
+  }
+
+  const Stats &jitter() const { return stats; }
+  void reset_jitter() { stats = Stats(); }
+
+private:
+  uint32_t next_due = 0;
+  Stats stats;
+};
+
+#endif // TICK_SCHEDULER_H
@@ -0,0 +1,69 @@
+#ifndef TONE_SEQUENCER_H
+#define TONE_SEQUENCER_H
+
+#include <stdint.h>
+#include <atomic>
+#include "spsc_queue.h"
+
+// One buzzer note; freq 0 is a rest
+struct Note
+{
+  uint16_t freq;
+  uint16_t ms;
+};
+
+// Note queue between whoever starts sounds (the game task) and the player
+// that times them (a one-shot hardware timer on the device, a simulated
+// clock on the host). play() only queues, so callers never wait for a
+// sound to finish.
+//
+// The player is not polled: it runs while there are notes and then goes
+// idle. play() reports when it found the player idle, and the caller then
+// restarts it by kicking the player's own context (fire the timer now),
+// never by calling next() itself: the player may still be finishing its
+// last call, and the output (LEDC) must have a single writer.
+template <size_t N>
+class ToneSequencer
+{
+public:
+  // Producer: queue notes (dropping any that do not fit). Returns true if
+  // the player was idle and must be started by the caller.
+  bool play(const Note *notes, uint8_t count)
+  {
+    for (uint8_t i = 0; i < count; i++)
+      if (!queue.push(notes[i]))
+        break;
+    return idle.exchange(false);
+  }
+
+  // Player: the next note to sound, or false once drained (go silent and
+  // stop; the next play() restarts the player).
+  bool next(Note &n)
+  {
+    if (queue.pop(n))
+      return true;
+    idle.store(true);
+    // a play() between the failed pop and idle=true saw the player busy and
+    // did not restart it, so pick its notes up here
+    if (!queue.empty() && idle.exchange(false))
+      return queue.pop(n);
+    return false;
+  }
+
+  bool is_idle() const { return idle.load(); }
+
+private:
+  SpscQueue<Note, N> queue;
+  std::atomic<bool> idle{true};
+};
+
+// The game's sound effects
+constexpr Note NOTES_STARTUP[] = {{1000, 100}, {0, 60}, {1200, 100}};
+constexpr Note NOTES_EAT[] = {{1500, 100}};
+constexpr Note NOTES_CLICK[] = {{2000, 30}};
+constexpr Note NOTES_GAME_OVER[] = {{600, 40}, {0, 40}, {720, 40}, {0, 60}, {840, 40},
+                                    {0, 80}, {960, 40}, {0, 100}, {1080, 40}, {0, 120}};
+
+#define NOTE_COUNT(notes) ((uint8_t)(sizeof(notes) / sizeof((notes)[0])))
+
+#endif // TONE_SEQUENCER_H
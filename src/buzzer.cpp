@@ -1,46 +1,65 @@
 #include "buzzer.h"
 #include "config.h"
+#include "tone_sequencer.h"
+#include "esp_timer.h"
 
 bool sound_enabled = true; // preserved name
 
-void playTone(uint32_t freq, uint32_t dur)
-{
-  if (!sound_enabled)
-    return;
-  tone(BUZZER_PIN, freq);
-  delay(dur);
-  noTone(BUZZER_PIN);
-}
+// Notes are queued by the game task and played by an esp_timer one-shot
+// that re-arms itself for each note's duration; the tone itself comes from
+// an LEDC channel, so nothing here ever delays the caller. Only the timer
+// callback touches LEDC: an idle player is restarted by firing the timer,
+// not by playing the note here, so a finishing callback's silence can never
+// land on a note the game task just started.
+static ToneSequencer<BUZZER_QUEUE_LEN> sequencer;
+static esp_timer_handle_t noteTimer = nullptr;
 
-void playStartupBeep()
+// Start the next queued note, or silence the buzzer when none are left
+static void nextNote(void *)
 {
-  if (sound_enabled)
+  Note n;
+  if (sequencer.next(n))
   {
-    playTone(1000, 100);
-    delay(60);
-    playTone(1200, 100);
+    ledcWriteTone(BUZZER_LEDC_CHANNEL, n.freq); // 0 = rest
+    esp_timer_start_once(noteTimer, (uint64_t)n.ms * 1000);
+  }
+  else
+  {
+    ledcWriteTone(BUZZER_LEDC_CHANNEL, 0);
   }
 }
 
-void playEatBeep()
+void initBuzzer()
 {
-  if (sound_enabled)
-    playTone(1500, 100);
+  ledcSetup(BUZZER_LEDC_CHANNEL, 2000, 8);
+  ledcAttachPin(BUZZER_PIN, BUZZER_LEDC_CHANNEL);
+  ledcWriteTone(BUZZER_LEDC_CHANNEL, 0);
+
+  esp_timer_create_args_t args = {};
+  args.callback = nextNote;
+  args.name = "buzzer";
+  esp_timer_create(&args, &noteTimer);
 }
 
-void playClickBeep()
+static void playNotes(const Note *notes, uint8_t count)
 {
-  if (sound_enabled)
-    playTone(2000, 30);
+  if (!sound_enabled || !noteTimer)
+    return;
+  // player was idle: fire the timer now, its callback starts the first note
+  if (sequencer.play(notes, count))
+    esp_timer_start_once(noteTimer, 0);
 }
 
-void playGameOverBeep()
+void playTone(uint32_t freq, uint32_t dur)
 {
-  if (!sound_enabled)
-    return;
-  for (int i = 0; i < 5; i++)
-  {
-    playTone(600 + i * 120, 40);
-    delay(40 + i * 20);
-  }
-}
\ No newline at end of file
+  Note n = {(uint16_t)freq, (uint16_t)dur};
+  playNotes(&n, 1);
+}
+
+void playStartupBeep() { playNotes(NOTES_STARTUP, NOTE_COUNT(NOTES_STARTUP)); }
+
+void playEatBeep() { playNotes(NOTES_EAT, NOTE_COUNT(NOTES_EAT)); }
+
+void playClickBeep() { playNotes(NOTES_CLICK, NOTE_COUNT(NOTES_CLICK)); }
+
+void playGameOverBeep() { playNotes(NOTES_GAME_OVER, NOTE_COUNT(NOTES_GAME_OVER)); }
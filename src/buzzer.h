@@ -3,8 +3,13 @@
 
 #include <Arduino.h>
 
+#define BUZZER_LEDC_CHANNEL 0
+#define BUZZER_QUEUE_LEN    32 // notes; a power of two
+
 extern bool sound_enabled;
 
+// All play* calls only queue notes and return immediately
+void initBuzzer();
 void playTone(uint32_t freq, uint32_t dur);
 void playStartupBeep();
 void playEatBeep();
@@ -0,0 +1,174 @@
+#include "compositor.h"
+#include "display.h"
+#include "game.h"
+
+// playfield border width (white, drawn over the edge cells)
+#define BORDER_PX 2
+
+struct DirtyRect
+{
+  int16_t x, y, w, h;
+};
+
+static GFXcanvas16 hud(SCREEN_W, HUD_H);
+static uint8_t scene[GRID_CELLS];
+static DirtyRect dirty[COMPOSITOR_MAX_RECTS];
+static uint8_t dirtyCount = 0;
+static bool suspended = false;
+static uint16_t line[SCREEN_W]; // one composed pixel row
+
+GFXcanvas16 &hudCanvas() { return hud; }
+
+static int32_t area(const DirtyRect &r) { return (int32_t)r.w * r.h; }
+
+static DirtyRect bounds(const DirtyRect &a, const DirtyRect &b)
+{
+  int16_t x0 = min(a.x, b.x), y0 = min(a.y, b.y);
+  int16_t x1 = max(a.x + a.w, b.x + b.w), y1 = max(a.y + a.h, b.y + b.h);
+  return {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+}
+
+// Overlapping or touching rects are merged when their bounding box costs no
+// more pixels than sending both: neighbouring cells in a row or column fold
+// into one window, diagonal neighbours stay separate.
+static bool worth_merging(const DirtyRect &a, const DirtyRect &b)
+{
+  bool touch = a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+  return touch && area(bounds(a, b)) <= area(a) + area(b);
+}
+
+void compositorMarkDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  // clip to the panel
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > (int)SCREEN_W) w = SCREEN_W - x;
+  if (y + h > (int)SCREEN_H) h = SCREEN_H - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  DirtyRect r = {x, y, w, h};
+
+  // keep folding r into the list until nothing else merges with it
+  for (uint8_t i = 0; i < dirtyCount;)
+  {
+    if (worth_merging(dirty[i], r))
+    {
+      r = bounds(dirty[i], r);
+      dirty[i] = dirty[--dirtyCount];
+      i = 0;
+    }
+    else
+      i++;
+  }
+
+  if (dirtyCount == COMPOSITOR_MAX_RECTS)
+  {
+    // list full: grow whichever rect absorbs r most cheaply
+    uint8_t best = 0;
+    int32_t bestCost = INT32_MAX;
+    for (uint8_t i = 0; i < dirtyCount; i++)
+    {
+      int32_t cost = area(bounds(dirty[i], r)) - area(dirty[i]);
+      if (cost < bestCost)
+      {
+        bestCost = cost;
+        best = i;
+      }
+    }
+    dirty[best] = bounds(dirty[best], r);
+    return;
+  }
+  dirty[dirtyCount++] = r;
+}
+
+void compositorSetCell(uint8_t gx, uint8_t gy, SpriteId id)
+{
+  if (gx >= GRID_W || gy >= GRID_H)
+    return;
+  uint8_t &c = scene[(uint16_t)gy * GRID_W + gx];
+  if (c == id)
+    return;
+  c = id;
+  compositorMarkDirty(PLAY_X + Game::col_px[gx], PLAY_Y + Game::row_px[gy], CELL, CELL);
+}
+
+void compositorClearCells()
+{
+  for (uint16_t i = 0; i < GRID_CELLS; i++)
+    scene[i] = SPRITE_EMPTY;
+  compositorMarkDirty(PLAY_X, PLAY_Y, PLAY_W, PLAY_H);
+}
+
+void compositorSuspend() { suspended = true; }
+
+void compositorInvalidate()
+{
+  suspended = false;
+  dirtyCount = 0;
+  compositorMarkDirty(0, 0, SCREEN_W, SCREEN_H);
+}
+
+// Compose w pixels of screen row y starting at x into line[]
+static void compose_row(int16_t x, int16_t y, int16_t w)
+{
+  if (y < PLAY_Y)
+  {
+    const uint16_t *src = hud.getBuffer();
+    if (src)
+      memcpy(line, src + (int32_t)y * SCREEN_W + x, w * sizeof(uint16_t));
+    else
+      for (int i = 0; i < w; i++)
+        line[i] = ILI9341_BLUE; // canvas allocation failed
+    return;
+  }
+
+  int py = y - PLAY_Y;
+  int gy = py / CELL, ry = py % CELL;
+  for (int i = 0; i < w;)
+  {
+    int px = x + i - PLAY_X;
+    int gx = px / CELL, rx = px % CELL;
+    int n = min(CELL - rx, w - i);
+    if (gx < GRID_W && gy < GRID_H)
+      memcpy(line + i, sprite_pixels((SpriteId)scene[gy * GRID_W + gx]) + ry * CELL + rx, n * sizeof(uint16_t));
+    else
+      for (int k = 0; k < n; k++)
+        line[i + k] = ILI9341_BLACK; // margin right/below the grid
+    i += n;
+  }
+
+  // border on top of the cells
+  if (py < BORDER_PX || py >= PLAY_H - BORDER_PX)
+  {
+    for (int i = 0; i < w; i++)
+      line[i] = ILI9341_WHITE;
+    return;
+  }
+  for (int i = 0; i < w; i++)
+  {
+    int px = x + i - PLAY_X;
+    if (px < BORDER_PX || px >= PLAY_W - BORDER_PX)
+      line[i] = ILI9341_WHITE;
+  }
+}
+
+void compositorFlush()
+{
+  if (suspended || dirtyCount == 0)
+    return;
+
+  tft.startWrite();
+  for (uint8_t i = 0; i < dirtyCount; i++)
+  {
+    const DirtyRect &r = dirty[i];
+    tft.setAddrWindow(r.x, r.y, r.w, r.h);
+    for (int16_t y = r.y; y < r.y + r.h; y++)
+    {
+      compose_row(r.x, y, r.w);
+      tft.writePixels(line, r.w);
+    }
+  }
+  tft.endWrite();
+  dirtyCount = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "config.h"
+#include "sprites.h"
+
+// Retained-mode renderer for the game screen. The scene is the HUD layer (an
+// offscreen RGB565 canvas) plus one sprite id per playfield cell, with the
+// playfield border overlaid. Drawing code only changes the scene and marks
+// rectangles dirty; compositorFlush() merges the dirty list and pushes each
+// rect with one address window inside a single SPI transaction per frame.
+// A cell changed several times in one frame is therefore sent once.
+
+#define COMPOSITOR_MAX_RECTS 32
+
+// HUD layer, SCREEN_W x HUD_H, drawn with normal GFX calls.
+// Mark what you touched with compositorMarkDirty().
+GFXcanvas16 &hudCanvas();
+
+// Set a playfield cell's sprite; marks it dirty only if it changed
+void compositorSetCell(uint8_t gx, uint8_t gy, SpriteId id);
+void compositorClearCells(); // every cell back to SPRITE_EMPTY
+
+// Screen-space rect to repaint from the scene at the next flush, e.g. after
+// drawing something directly on the panel on top of it
+void compositorMarkDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Full-screen pages (game over, splash) draw on the panel directly: suspend
+// stops flushing, invalidate resumes and repaints the whole scene.
+void compositorSuspend();
+void compositorInvalidate();
+
+void compositorFlush(); // push all dirty rects; no-op when nothing changed
+
+#endif // COMPOSITOR_H
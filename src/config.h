@@ -3,9 +3,21 @@
 
 #include <Arduino.h>
 
+// Panel variant: override from platformio.ini build_flags, e.g.
+//   -DPANEL_SCREEN_W=320 -DPANEL_SCREEN_H=480 -DPANEL_CELL=12
+#ifndef PANEL_SCREEN_W
+#define PANEL_SCREEN_W 240
+#endif
+#ifndef PANEL_SCREEN_H
+#define PANEL_SCREEN_H 320
+#endif
+#ifndef PANEL_CELL
+#define PANEL_CELL 10
+#endif
+
 // Screen dimensions (use types that fit 320)
-constexpr uint16_t SCREEN_W = 240;
-constexpr uint16_t SCREEN_H = 320;
+constexpr uint16_t SCREEN_W = PANEL_SCREEN_W;
+constexpr uint16_t SCREEN_H = PANEL_SCREEN_H;
 
 
 // Layout
@@ -15,9 +27,14 @@ constexpr uint16_t PLAY_Y  = HUD_H;
 constexpr uint16_t PLAY_W  = SCREEN_W;
 constexpr uint16_t PLAY_H  = SCREEN_H - HUD_H;
 
-constexpr uint8_t CELL    = 10;
+constexpr uint8_t CELL    = PANEL_CELL;
 constexpr uint8_t CELL_SP = 2;
 
+// Playfield grid in cells
+constexpr uint8_t  GRID_W     = PLAY_W / CELL;
+constexpr uint8_t  GRID_H     = PLAY_H / CELL;
+constexpr uint16_t GRID_CELLS = (uint16_t)GRID_W * GRID_H;
+
 // Pins (ESP32 mapping for v4.1)
 #define TFT_CS    5
 #define TFT_DC    2
@@ -42,7 +59,4 @@ extern const char *password;
 #define IR_RESET_CODE        0xC0000C
 #define IR_SOUND_TOGGLE_CODE 0xC0000D
 
-// Game constants
-#define MAX_LEN 300
-
 #endif // CONFIG_H
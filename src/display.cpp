@@ -2,10 +2,24 @@
 #include "game.h"
 #include "buzzer.h"
 #include "config.h"
+#include "sprites.h"
+#include "compositor.h"
+#include "hud_view.h"
+#include "font.h"
 
 #include <Adafruit_ILI9341.h>
 #include <TJpg_Decoder.h>
 #include "SPIFFS.h"
+#include "rle565.h"
+
+// Splash pre-decoded at build time by tools/build_splash.py; without it the
+// JPEG in SPIFFS is decoded at runtime as before
+#if __has_include("splash_rle.h")
+#include "splash_rle.h"
+#define HAVE_SPLASH_RLE 1
+#endif
+
+#define SPLASH_BURST_PX 1024 // pixels per SPI burst while streaming the splash
 
 // TFT instance (use pins from config.h)
 Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
@@ -27,6 +41,9 @@ void initDisplay()
   tft.begin();
   tft.setRotation(0); // Portrait (default, 240x320)
   tft.fillScreen(ILI9341_BLACK);
+
+  initSprites();
+  initHUD();
 }
 
 // ---------- helper used by TJpg_Decoder ----------
@@ -64,152 +81,47 @@ void drawJpegFromSPIFFS(const char *filename, int16_t x = 0, int16_t y = 0)
   TJpgDec.drawFsJpg(x, y, filename); // draw from SPIFFS (works with Bodmer TJpg_Decoder)
 }
 
-// --- Keep the old draw helpers but adapted to color TFT ---
-// You can rename / reuse your old functions; here I provide versions that call tft.
-
-int textWidthChars(const char *s, uint8_t textSize)
-{
-  int len = strlen(s);
-  return len * 6 * textSize; // approximate same as old code
-}
-
-void drawBoldRect(int x, int y, int w, int h)
-{
-  tft.drawRect(x, y, w, h, ILI9341_WHITE);
-  tft.drawRect(x + 1, y + 1, w - 2, h - 2, ILI9341_WHITE);
-}
-void drawThinHUDBorder() { tft.drawRect(0, 0, SCREEN_W, HUD_H, ILI9341_WHITE); }
-
-void drawPauseIcon(int x, int y) { 
-  tft.fillRect(x, y, 6, 12, ILI9341_WHITE);
-  tft.fillRect(x+10, y, 6, 12, ILI9341_WHITE);
-   /* you can fine tune */ }
-void drawPlayIcon(int x, int y) { tft.fillTriangle(x, y, x, y + 12, x + 10, y + 6, ILI9341_WHITE); }
-
-void drawSpeakerOnIcon(int x, int y)
+#ifdef HAVE_SPLASH_RLE
+// Stream the flash-resident splash: one address window, pixels decoded
+// straight into big-endian bursts
+static void drawSplashRle()
 {
-  // Speaker body (a small trapezoid/rectangle)
-  tft.fillRect(x, y + 3, 4, 10, ILI9341_WHITE);               // rectangle part
-  tft.fillTriangle(x + 4, y + 3, x + 4, y + 12, x + 9, y + 7, ILI9341_WHITE); // cone
-
-  // Sound waves (two arcs/curves)
-  tft.drawLine(x + 11, y + 5, x + 13, y + 7, ILI9341_WHITE);
-  tft.drawLine(x + 13, y + 7, x + 11, y + 10, ILI9341_WHITE);
-
-  tft.drawLine(x + 15, y + 3, x + 18, y + 7, ILI9341_WHITE);
-  tft.drawLine(x + 18, y + 7, x + 15, y + 12, ILI9341_WHITE);
-}
-
-void drawSpeakerMutedIcon(int x, int y)
-{
-  // Base speaker (same as ON)
-  drawSpeakerOnIcon(x, y);
-
-  // Mute cross (X over the speaker)
-  tft.drawLine(x, y, x + 18, y + 16, ILI9341_RED);
-  tft.drawLine(x + 18, y, x, y + 16, ILI9341_RED);
+  static uint16_t burst[SPLASH_BURST_PX];
+  tft.startWrite();
+  tft.setAddrWindow(0, 0, SPLASH_RLE_WIDTH, SPLASH_RLE_HEIGHT);
+  rle565_decode(SPLASH_RLE, sizeof(SPLASH_RLE), (uint8_t *)burst, SPLASH_BURST_PX,
+                [](uint8_t *px, size_t n) { tft.writePixels((uint16_t *)px, n, true, true); });
+  tft.endWrite();
 }
+#endif
 
+// Scene version: bumped by every state change that affects what is shown
+// (tick, score, pause, mute, game over, restart). present_frame() redraws
+// only when it moved since the last present, so a paused or game-over screen
+// is drawn once on the transition and then left alone.
+static uint32_t sceneVersion = 1;
+static uint32_t shownVersion = 0;
 
-void draw_cell_fill(uint8_t gx, uint8_t gy)
+// Call after changing anything on screen; drawing happens in present_frame()
+void draw_frame()
 {
-  int px = PLAY_X + gx * CELL;
-  int py = PLAY_Y + gy * CELL;
-  if (px < 0 || py < 0 || px + CELL > SCREEN_W || py + CELL > SCREEN_H)
-    return;
-  tft.fillRect(px, py, CELL, CELL, ILI9341_WHITE);
+  sceneVersion++;
 }
 
-void draw_fruit_cell(uint8_t gx, uint8_t gy)
+// Once per game-loop iteration: bring the panel up to date with the state
+void present_frame()
 {
-  int px = PLAY_X + gx * CELL;
-  int py = PLAY_Y + gy * CELL;
-  if (px < 0 || py < 0 || px + CELL > SCREEN_W || py + CELL > SCREEN_H)
-    return;
-
-  // Ensure the previous contents are cleared
-  tft.fillRect(px, py, CELL, CELL, ILI9341_BLACK);
-
-  int cx = px + CELL / 2;
-  int cy = py + CELL / 2;
-  int r = max(1, (int)CELL / 2);
-  tft.fillCircle(cx, cy, r-1, ILI9341_WHITE);
-}
-
-
-
-void draw_HUD()
-{
-  // Draw HUD background
-  tft.fillRect(0, 0, SCREEN_W, HUD_H, ILI9341_BLUE);
-
-  // Draw text
-  tft.setTextColor(ILI9341_WHITE, ILI9341_BLUE);
-  tft.setTextSize(2);
-  tft.setCursor(4, 2);
-  tft.printf("LVL:%d SCORE:%d", level, score);
-
-  // Clear and draw pause/play icon area (prevent leftover)
-  int iconX = SCREEN_W - 60;
-  int iconY = 2;
-  tft.fillRect(iconX, iconY, 20, HUD_H - 4, ILI9341_BLUE); // clear icon area
-  if (paused)
-    drawPlayIcon(iconX, iconY);
-  else
-    drawPauseIcon(iconX, iconY);
-
-  // Clear and draw sound icon area
-  tft.fillRect(SCREEN_W - 28, 2, 26, HUD_H - 4, ILI9341_BLUE);
-  if (sound_enabled)
-    drawSpeakerOnIcon(SCREEN_W - 20, 2);
-  else
-    drawSpeakerMutedIcon(SCREEN_W - 20, 2);
-
-  drawThinHUDBorder();
-}
-
-
-
-void draw_playfield()
-{
-  draw_fruit_cell(food_x, food_y);
-  for (int i = 0; i < snake_len; i++)
+  if (splashActive())
+    return; // the splash draws itself
+  if (shownVersion != sceneVersion)
   {
-    int gx = xs[i], gy = ys[i];
-    int px = PLAY_X + gx * CELL, py = PLAY_Y + gy * CELL;
-    if (i == 0)
-      tft.fillRect(px, py, CELL, CELL, ILI9341_GREEN);
+    shownVersion = sceneVersion;
+    if (game.game_over)
+      draw_game_over_screen();
     else
-      tft.fillRoundRect(px, py, CELL, CELL, 2, ILI9341_YELLOW);
+      draw_HUD(); // snake and fruit cells are already in the scene via game events
   }
-}
-
-void draw_playfield_border() { drawBoldRect(PLAY_X, PLAY_Y, PLAY_W, PLAY_H); }
-
-void draw_frame()
-{
-  // Update HUD and border (lightweight)
-  draw_HUD();
-  draw_playfield_border();
-
-  // If paused -> draw pause overlay; else clear overlay area (so previous pause bars are erased)
-  int cx = PLAY_X + PLAY_W / 2;
-  int cy = PLAY_Y + PLAY_H / 2;
-  int bar_w = 12, bar_h = 36, gap = 16;
-  int overlay_x = cx - gap/2 - bar_w;
-  int overlay_w = bar_w * 2 + gap;
-  int overlay_y = cy - bar_h/2;
-  int overlay_h = bar_h;
-
-  // if (paused) {
-  //   tft.fillRect(overlay_x, overlay_y, bar_w, bar_h, ILI9341_WHITE);
-  //   tft.fillRect(overlay_x + bar_w + gap, overlay_y, bar_w, bar_h, ILI9341_WHITE);
-  // } else {
-  //   // clear the overlay region (only this rectangle) with playfield background color
-  //   tft.fillRect(overlay_x, overlay_y, overlay_w, overlay_h, ILI9341_BLACK);
-  // }
-
-  // Note: snake & fruit are managed incrementally by move_snake() and safeSpawnFood()
+  compositorFlush(); // no-op when nothing is dirty
 }
 
 
@@ -217,96 +129,126 @@ void draw_frame()
 // game over screen
 void draw_game_over_screen()
 {
+  // full-screen page: keep the compositor off the panel until the next game
+  compositorSuspend();
   tft.fillScreen(ILI9341_BLACK);   // black background looks cleaner for game over
 
   // Title: GAME OVER
-  const char *title = "GAME OVER";
-  tft.setTextSize(4);
-  tft.setTextColor(ILI9341_RED, ILI9341_BLACK);
-  int titleWidth = strlen(title) * 6 * 4;
-  int titleX = (SCREEN_W - titleWidth) / 2;
   int titleY = SCREEN_H / 4;
-  tft.setCursor(titleX, titleY);
-  tft.print(title);
+  drawTextCentered(titleY, "GAME OVER", 4, ILI9341_RED, ILI9341_BLACK);
 
   // Final Score
   char buf[32];
-  snprintf(buf, sizeof(buf), "FINAL SCORE: %d", score);
-  tft.setTextSize(2);
-  tft.setTextColor(ILI9341_WHITE, ILI9341_BLACK);
-  int scoreWidth = strlen(buf) * 6 * 2;
-  int scoreX = (SCREEN_W - scoreWidth) / 2;
-  int scoreY = titleY + 50;
-  tft.setCursor(scoreX, scoreY);
-  tft.print(buf);
+  snprintf(buf, sizeof(buf), "FINAL SCORE: %d", game.score);
+  drawTextCentered(titleY + 50, buf, 2, ILI9341_WHITE, ILI9341_BLACK);
 
   // Restart prompt
-  const char *restart = "PRESS RESTART";
-  tft.setTextSize(2);
-  tft.setTextColor(ILI9341_YELLOW, ILI9341_BLACK);
-  int restartWidth = strlen(restart) * 6 * 2;
-  int restartX = (SCREEN_W - restartWidth) / 2;
-  int restartY = SCREEN_H - 60;
-  tft.setCursor(restartX, restartY);
-  tft.print(restart);
+  drawTextCentered(SCREEN_H - 60, "PRESS RESTART", 2, ILI9341_YELLOW, ILI9341_BLACK);
 }
 
 
-// splash with JPEG support
-void showSplashAndCountdown()
+// Text drawn straight onto the game screen; the area is repainted from the
+// scene (erasing the text) at the next flush
+static void draw_overlay_text(int x, int y, uint8_t size, const char *text)
 {
-  // prefer JPEG (logo.jpg in SPIFFS data/)
-  tft.fillScreen(ILI9341_BLACK);
-  draw_HUD(); // draw HUD background so HUD area is not black while jpg renders
+  drawText(x, y, text, size, ILI9341_WHITE, ILI9341_BLACK);
+  compositorMarkDirty(x, y, textWidth(text, size), textHeight(size));
+}
+
+// Splash + countdown, advanced by splashUpdate() from the game loop instead
+// of blocking on delay(): logo, 3, 2, 1, Go!, then the caller starts the game.
+// Input, networking and voice keep running throughout, and restarting again
+// just starts the sequence over.
+enum SplashState : uint8_t
+{
+  SPLASH_IDLE,
+  SPLASH_LOGO,
+  SPLASH_COUNT, // showing splashCount
+  SPLASH_GO
+};
+
+#define SPLASH_LOGO_MS  1400
+#define SPLASH_COUNT_MS 1000
+#define SPLASH_GO_MS    800
+
+static SplashState splashState = SPLASH_IDLE;
+static uint8_t splashCount = 0;
+static unsigned long splashDue = 0;
+
+// Replace the previous overlay (erased by the flush) with a new one
+static void splash_overlay(int x, int y, uint8_t size, const char *text)
+{
+  compositorFlush();
+  draw_overlay_text(x, y, size, text);
+  playClickBeep();
+}
+
+static void splash_show_count()
+{
+  char digit[2] = {(char)('0' + splashCount), 0};
+  splash_overlay(PLAY_X + (PLAY_W / 2) - 10, PLAY_Y + (PLAY_H / 2) - 20, 6, digit);
+}
+
+void splashStart()
+{
+  // empty playfield + HUD background so HUD area is not black while jpg renders
+  compositorClearCells();
+  draw_HUD();
+  compositorInvalidate();
+  compositorFlush();
+
+  // prefer the built-in image, then JPEG (logo.jpg in SPIFFS data/)
+  compositorSuspend();
+#ifdef HAVE_SPLASH_RLE
+  drawSplashRle();
+#else
   const char *jpg = "/logo.jpg";
   if (SPIFFS.exists(jpg))
-  {
     drawJpegFromSPIFFS(jpg, 0, 0); // splash image
-    delay(1400);
-  }
   else
-  {
-    tft.setTextSize(3);
-    tft.setTextColor(ILI9341_WHITE);
-    tft.setCursor(40, 90);
-    tft.print("HUNGRY SNAKE");
-    delay(1400);
-  }
+    drawTextCentered(90, "HUNGRY SNAKE", 3, ILI9341_WHITE, ILI9341_BLACK);
+#endif
 
-  playStartupBeep();
+  splashState = SPLASH_LOGO;
+  splashDue = millis() + SPLASH_LOGO_MS;
+}
 
-  // countdown (3..1)
-  for (int n = 3; n >= 1; --n)
-  {
-    // clear only the playfield, not entire width
-    tft.fillRect(PLAY_X, PLAY_Y, PLAY_W, PLAY_H, ILI9341_BLACK);
-    draw_HUD();
-    draw_playfield_border();
-
-    tft.setTextSize(6);
-    tft.setTextColor(ILI9341_WHITE);
-    int cx = PLAY_X + (PLAY_W / 2) - 10;
-    int cy = PLAY_Y + (PLAY_H / 2) - 20;
-    tft.setCursor(cx, cy);
-    tft.printf("%d", n);
-
-    playClickBeep();
-    delay(1000);
-  }
+bool splashActive() { return splashState != SPLASH_IDLE; }
 
-  // Go!
-  tft.fillRect(PLAY_X, PLAY_Y, PLAY_W, PLAY_H, ILI9341_BLACK);
-  draw_HUD();
-  draw_playfield_border();
+void splashCancel() { splashState = SPLASH_IDLE; }
 
-  tft.setTextSize(4);
-  tft.setTextColor(ILI9341_WHITE);
-  tft.setCursor(PLAY_X + PLAY_W / 2 - 32, PLAY_Y + PLAY_H / 2 - 14);
-  tft.print("Go!");
-  playClickBeep();
-  delay(800);
+bool splashUpdate(unsigned long now)
+{
+  if (splashState == SPLASH_IDLE || (long)(now - splashDue) < 0)
+    return false;
 
-  // final clear before starting game
-  tft.fillRect(PLAY_X, PLAY_Y, PLAY_W, PLAY_H, ILI9341_BLACK);
-  draw_frame();
+  switch (splashState)
+  {
+  case SPLASH_LOGO:
+    playStartupBeep();
+    compositorInvalidate(); // back to the (empty) game screen
+    splashCount = 3;
+    splash_show_count();
+    splashState = SPLASH_COUNT;
+    splashDue += SPLASH_COUNT_MS;
+    return false;
+
+  case SPLASH_COUNT:
+    if (--splashCount > 0)
+    {
+      splash_show_count();
+      splashDue += SPLASH_COUNT_MS;
+      return false;
+    }
+    // "Go!" is erased by the first game frame
+    splash_overlay(PLAY_X + PLAY_W / 2 - 32, PLAY_Y + PLAY_H / 2 - 14, 4, "Go!");
+    splashState = SPLASH_GO;
+    splashDue += SPLASH_GO_MS;
+    return false;
+
+  case SPLASH_GO:
+  default:
+    splashState = SPLASH_IDLE;
+    return true;
+  }
 }
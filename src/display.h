@@ -10,15 +10,17 @@ extern Adafruit_ILI9341 tft;
 
 // Display API used across project (declare the functions you call elsewhere)
 void initDisplay();
-void draw_frame();
-void draw_playfield();
+void draw_frame();      // mark the scene changed (cheap; call on every state change)
+void present_frame();   // redraw what changed since the last present, once per loop
 void draw_HUD();
-void draw_playfield_border();
 void draw_game_over_screen();
-void showSplashAndCountdown();
-void drawJpegFromSPIFFS(const char *filename, int16_t x, int16_t y);
 
-void draw_fruit_cell(uint8_t gx, uint8_t gy);
+// Non-blocking splash + countdown, advanced from the game loop
+void splashStart();
+bool splashActive();
+bool splashUpdate(unsigned long now); // true once, when the countdown has ended
+void splashCancel();
 
+void drawJpegFromSPIFFS(const char *filename, int16_t x, int16_t y);
 
 #endif // DISPLAY_H
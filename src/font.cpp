@@ -0,0 +1,60 @@
+#include "font.h"
+#include "display.h"
+
+static uint16_t line[SCREEN_W];
+
+static const uint8_t *glyph_rows(char c)
+{
+  if (c < FONT_FIRST || c > FONT_LAST)
+    c = '?';
+  return FONT5X7_ROWS.rows[c - FONT_FIRST];
+}
+
+// Expand font row r (FONT_ROWS.. is the blank spacing row) of one glyph,
+// each font pixel repeated size times, into dst; returns pixels written
+static uint16_t expand_row(char c, uint8_t r, uint8_t size, uint16_t fg, uint16_t bg, uint16_t *dst, uint16_t max)
+{
+  uint8_t bits = r < FONT_ROWS ? glyph_rows(c)[r] : 0;
+  uint16_t n = 0;
+  for (uint8_t col = 0; col < FONT_CELL_W; col++)
+  {
+    uint16_t color = (bits >> col) & 1 ? fg : bg;
+    for (uint8_t k = 0; k < size && n < max; k++)
+      dst[n++] = color;
+  }
+  return n;
+}
+
+void drawText(int16_t x, int16_t y, const char *s, uint8_t size, uint16_t fg, uint16_t bg)
+{
+  if (x < 0 || y < 0 || x >= (int)SCREEN_W || y >= (int)SCREEN_H || size == 0)
+    return;
+  int16_t w = min((int)textWidth(s, size), SCREEN_W - x);
+  int16_t h = min((int)textHeight(size), SCREEN_H - y);
+  if (w <= 0)
+    return;
+
+  tft.startWrite();
+  tft.setAddrWindow(x, y, w, h);
+  for (int16_t row = 0; row < h; row += size)
+  {
+    // one composed line serves all size copies of a font row
+    uint16_t n = 0;
+    for (const char *p = s; *p && n < w; p++)
+      n += expand_row(*p, row / size, size, fg, bg, line + n, w - n);
+    for (uint8_t k = 0; k < size && row + k < h; k++)
+      tft.writePixels(line, w);
+  }
+  tft.endWrite();
+}
+
+void drawTextCentered(int16_t y, const char *s, uint8_t size, uint16_t fg, uint16_t bg)
+{
+  drawText(max(0, (SCREEN_W - textWidth(s, size)) / 2), y, s, size, fg, bg);
+}
+
+void renderGlyph(char c, uint8_t size, uint16_t fg, uint16_t bg, uint16_t *dst, uint16_t stride)
+{
+  for (uint8_t row = 0; row < FONT_CELL_H * size; row++)
+    expand_row(c, row / size, size, fg, bg, dst + row * stride, FONT_CELL_W * size);
+}
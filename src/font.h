@@ -0,0 +1,25 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <Arduino.h>
+#include "font5x7.h"
+
+// Text renderer over the compile-time 5x7 font. A string is sent as one
+// address window with its scaled pixel rows streamed in bursts, instead of
+// Adafruit GFX drawing every lit font pixel as a separate fillRect. Always
+// opaque: unlit pixels are painted bg. Same cell size as GFX text (6x8 per
+// size step), so layouts carry over.
+#define FONT_CELL_W 6
+#define FONT_CELL_H 8
+
+inline int16_t textWidth(const char *s, uint8_t size) { return strlen(s) * FONT_CELL_W * size; }
+inline int16_t textHeight(uint8_t size) { return FONT_CELL_H * size; }
+
+// Draw on the panel (own SPI transaction); clipped to the screen
+void drawText(int16_t x, int16_t y, const char *s, uint8_t size, uint16_t fg, uint16_t bg);
+void drawTextCentered(int16_t y, const char *s, uint8_t size, uint16_t fg, uint16_t bg);
+
+// Render one glyph cell into a pixel buffer with the given row stride
+void renderGlyph(char c, uint8_t size, uint16_t fg, uint16_t bg, uint16_t *dst, uint16_t stride);
+
+#endif // FONT_H
@@ -3,22 +3,21 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "snake_game.h"
+#include "tick_scheduler.h"
 
-extern uint8_t xs[MAX_LEN];
-extern uint8_t ys[MAX_LEN];
-extern uint16_t snake_len;
-extern int8_t direction; // 0=Up,1=Right,2=Down,3=Left
-extern bool food_eaten;
-extern uint8_t food_x;
-extern uint8_t food_y;
-extern bool game_over;
-extern bool paused;
-extern int score;
-extern int level;
-extern int snake_speed;
+// Game core specialised for this build's panel/cell size
+using Game = SnakeGame<GRID_W, GRID_H, CELL>;
+extern Game game;
 
+// Fixed-timestep scheduler for game ticks (period = game.snake_speed)
+extern TickScheduler ticker;
+
+void game_turn(int8_t dir);
+void game_toggle_pause();
 void safeSpawnFood();
 void move_snake();
 void restart_with_splash();
+void start_game(); // called by the game loop when the countdown ends
 
-#endif // GAME_H
\ No newline at end of file
+#endif // GAME_H
@@ -0,0 +1,632 @@
+// Voice DSP checks for the native sim: the optimised Edge Impulse DSP code is
+// compared against plain reference versions on synthetic audio, with the
+// project's own MFCC block configuration.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_run_dsp.h"
+#include "snake_rng.h"
+#include "dsp_checks.h"
+
+using namespace ei;
+
+// --- SDK porting layer for the host ------------------------------------------
+
+EI_IMPULSE_ERROR ei_run_impulse_check_canceled() { return EI_IMPULSE_OK; }
+EI_IMPULSE_ERROR ei_sleep(int32_t) { return EI_IMPULSE_OK; }
+
+uint64_t ei_read_timer_us()
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+uint64_t ei_read_timer_ms() { return ei_read_timer_us() / 1000; }
+
+void ei_printf(const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+}
+void ei_printf_float(float f) { printf("%f", f); }
+void ei_putchar(char c) { putchar(c); }
+
+// Every heap allocation is counted: the SDK's own through ei_malloc/ei_calloc,
+// and anything else through the global operator new
+static size_t heap_allocs = 0;
+
+void *ei_malloc(size_t size)
+{
+  heap_allocs++;
+  return malloc(size);
+}
+void *ei_calloc(size_t nitems, size_t size)
+{
+  heap_allocs++;
+  return calloc(nitems, size);
+}
+void ei_free(void *ptr) { free(ptr); }
+
+void *operator new(size_t size)
+{
+  heap_allocs++;
+  if (void *ptr = malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+// --- Test signal ---------------------------------------------------------------
+
+// Same values as ei_dsp_config_790660_10 in model-parameters/model_variables.h
+static ei_dsp_config_mfcc_t mfcc_config = {
+    10, 4, 1, nullptr, 0,
+    13,     // num_cepstral
+    0.025f, // frame_length
+    0.01f,  // frame_stride
+    32,     // num_filters
+    256,    // fft_length
+    101,    // win_size
+    0, 0,   // low/high frequency
+    0.98f,  // pre_cof
+    1       // pre_shift
+};
+
+constexpr size_t WINDOW_SAMPLES = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+constexpr size_t SEGMENT_SAMPLES = 2000;
+
+// Deterministic microphone-like audio (raw int16 scale): stretches of exact
+// silence, noise at random levels, tones and loud bursts. Loud-then-silent
+// stretches are what broke a naive running-sum cmvnw.
+static std::vector<float> make_audio(size_t samples, uint32_t seed)
+{
+  SnakeRng rng(seed);
+  std::vector<float> audio(samples);
+  for (size_t start = 0; start < samples; start += SEGMENT_SAMPLES)
+  {
+    uint32_t kind = rng.below(4);
+    float amp = 50.0f + rng.below(8000);
+    float freq = 200.0f + rng.below(3800);
+    for (size_t i = start; i < start + SEGMENT_SAMPLES && i < samples; i++)
+    {
+      float noise = (float)rng.below(2001) / 1000.0f - 1.0f;
+      float v = 0.0f;
+      if (kind == 1)
+        v = amp * noise;
+      else if (kind == 2)
+        v = 3000.0f * sinf(2.0f * (float)M_PI * freq * i / EI_CLASSIFIER_FREQUENCY) + 30.0f * noise;
+      else if (kind == 3)
+        v = 30000.0f * noise;
+      audio[i] = v;
+    }
+  }
+  return audio;
+}
+
+static const float *g_audio;
+
+static int audio_get_data(size_t offset, size_t length, float *out)
+{
+  memcpy(out, g_audio + offset, length * sizeof(float));
+  return 0;
+}
+
+// Raw MFCC features (rows x num_cepstral, no normalization) of one window
+static bool window_mfcc(const float *audio, matrix_t *out)
+{
+  g_audio = audio;
+  signal_t signal;
+  signal.total_length = WINDOW_SAMPLES;
+  signal.get_data = &audio_get_data;
+  return extract_mfcc_features(&signal, out, &mfcc_config, EI_CLASSIFIER_FREQUENCY) == EIDSP_OK;
+}
+
+// --- [cmvn] sliding-window cmvnw vs the O(rows * win) definition -----------------
+
+static size_t reflect(int32_t ix, size_t size)
+{
+  int32_t period = 2 * (int32_t)size;
+  int32_t m = ((ix % period) + period) % period;
+  return m < (int32_t)size ? m : period - 1 - m;
+}
+
+// cmvnw as speechpy defines it, in double: every row's window is summed
+// from scratch over the symmetrically padded column. Writes the reference
+// output and each value's window std (0 without variance normalization).
+static void cmvnw_reference(const float *in, size_t rows, size_t cols, int win, bool variance,
+                            std::vector<double> &out, std::vector<double> &window_std)
+{
+  const int32_t pad = (win - 1) / 2;
+  std::vector<double> x(rows), y(rows);
+  out.assign(rows * cols, 0.0);
+  window_std.assign(rows * cols, 0.0);
+
+  for (size_t col = 0; col < cols; col++)
+  {
+    for (size_t r = 0; r < rows; r++)
+      x[r] = in[r * cols + col];
+
+    for (size_t r = 0; r < rows; r++)
+    {
+      double sum = 0.0;
+      for (int32_t k = 0; k < win; k++)
+        sum += x[reflect((int32_t)r - pad + k, rows)];
+      y[r] = x[r] - sum / win;
+      out[r * cols + col] = y[r];
+    }
+
+    if (!variance)
+      continue;
+
+    for (size_t r = 0; r < rows; r++)
+    {
+      double sum = 0.0;
+      for (int32_t k = 0; k < win; k++)
+        sum += y[reflect((int32_t)r - pad + k, rows)];
+      double mean = sum / win, m2 = 0.0;
+      for (int32_t k = 0; k < win; k++)
+      {
+        double d = y[reflect((int32_t)r - pad + k, rows)] - mean;
+        m2 += d * d;
+      }
+      double sd = sqrt(m2 / win);
+      out[r * cols + col] = y[r] / (sd + 1e-10);
+      window_std[r * cols + col] = sd;
+    }
+  }
+}
+
+struct CmvnStats
+{
+  size_t cases = 0;
+  size_t values = 0;
+  size_t flat = 0; // outputs of (numerically) constant windows, not compared
+  double worst = 0.0;
+};
+
+// Run the SDK cmvnw on a copy of in and compare it to the reference. A
+// window with (near) zero spread divides rounding noise by 1e-10 in both
+// versions, so those outputs carry no information and are skipped.
+static bool compare_cmvnw(const float *in, size_t rows, size_t cols, int win, bool variance, CmvnStats &st)
+{
+  matrix_t m(rows, cols);
+  memcpy(m.buffer, in, rows * cols * sizeof(float));
+  if (speechpy::processing::cmvnw(&m, win, variance, false) != EIDSP_OK)
+    return false;
+
+  std::vector<double> ref, sd;
+  cmvnw_reference(in, rows, cols, win, variance, ref, sd);
+
+  bool ok = true;
+  for (size_t i = 0; i < rows * cols; i++)
+  {
+    if (variance && sd[i] < 1e-3)
+    {
+      st.flat++;
+      continue;
+    }
+    double err = fabs(m.buffer[i] - ref[i]) / fmax(1.0, fabs(ref[i]));
+    if (err > st.worst)
+      st.worst = err;
+    if (err > 1e-3)
+      ok = false;
+    st.values++;
+  }
+  st.cases++;
+  return ok;
+}
+
+int run_cmvn_check()
+{
+  bool ok = true;
+  const size_t cols = mfcc_config.num_cepstral;
+  const size_t rows = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE / cols;
+
+  // MFCC windows of synthetic audio at the device's 250 ms hop, with the
+  // model's window, no variance, a window wider than the matrix and a short one
+  {
+    CmvnStats st;
+    bool same = true;
+    std::vector<float> audio = make_audio(8 * WINDOW_SAMPLES, 1);
+    matrix_t features(1, EI_CLASSIFIER_NN_INPUT_FRAME_SIZE);
+    for (size_t off = 0; off + WINDOW_SAMPLES <= audio.size(); off += WINDOW_SAMPLES / 4)
+    {
+      if (!window_mfcc(&audio[off], &features))
+        return 1;
+      same &= compare_cmvnw(features.buffer, rows, cols, mfcc_config.win_size, true, st);
+      same &= compare_cmvnw(features.buffer, rows, cols, mfcc_config.win_size, false, st);
+      same &= compare_cmvnw(features.buffer, rows, cols, 301, true, st);
+      same &= compare_cmvnw(features.buffer, rows, cols, 7, true, st);
+    }
+    printf("cmvn: %zu MFCC windows, %zu values, worst rel err %.2g (%zu flat-window values skipped)\n",
+           st.cases, st.values, st.worst, st.flat);
+    ok &= check(same, "cmvn: MFCC windows match the reference");
+  }
+
+  // random matrices of every shape, with an offset so the mean matters
+  {
+    CmvnStats st;
+    bool same = true;
+    SnakeRng rng(5);
+    for (int it = 0; it < 300; it++)
+    {
+      size_t r = 1 + rng.below(120), c = 1 + rng.below(20);
+      int win = 1 + 2 * rng.below(80);
+      std::vector<float> v(r * c);
+      for (float &x : v)
+        x = 30.0f + ((float)rng.below(20001) - 10000.0f) * 0.01f;
+      same &= compare_cmvnw(v.data(), r, c, win, true, st);
+      same &= compare_cmvnw(v.data(), r, c, win, false, st);
+    }
+    printf("cmvn: %zu random matrices, worst rel err %.2g\n", st.cases, st.worst);
+    ok &= check(same, "cmvn: random matrices match the reference");
+  }
+
+  return ok ? 0 : 1;
+}
+
+// --- [scratch] heap use of the continuous MFCC path ------------------------------
+
+constexpr int SCRATCH_WARMUP_SLICES = 2;
+
+struct SliceRun
+{
+  size_t slices = 0;
+  size_t warm_allocs = 0;   // heap allocations after the warmup slices
+  size_t fallbacks = 0;
+  size_t live_at_reset = 0; // arena blocks still allocated when a slice ended
+  size_t rolled_bad = 0;    // slices that didn't keep the older rolling features
+  std::vector<float> windows; // normalized features of every full window
+};
+
+// One slice through the DSP half of process_impulse_continuous()
+// (ei_run_classifier.h), in the same order: the static rolling features are
+// built before the scratch scope opens, then the result and feature arrays,
+// the MFCC slice and the normalized copy come from the arena. The NN is
+// left out. Returns the rolling buffer and the features this slice wrote.
+static bool continuous_slice(signal_t *signal, size_t &features_written, const float *&rolling,
+                             size_t &written_now, std::vector<float> &windows)
+{
+  const size_t features_count = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE;
+  static matrix_t static_features_matrix(1, features_count);
+  if (!static_features_matrix.buffer)
+    return false;
+  rolling = static_features_matrix.buffer;
+
+  ei_dsp_scratch_scope_t dsp_scratch;
+  ei_dsp_scratch_array_t<ei_feature_t> raw_results(1);
+  if (raw_results.get() == nullptr)
+    return false;
+
+  matrix_t fm(1, features_count, static_features_matrix.buffer);
+  matrix_size_t written = {0, 0};
+  if (extract_mfcc_per_slice_features(signal, &fm, &mfcc_config, EI_CLASSIFIER_FREQUENCY, &written) != EIDSP_OK)
+    return false;
+  written_now = written.rows * written.cols;
+  features_written += written_now;
+
+  if (features_written >= features_count)
+  {
+    ei_dsp_scratch_array_t<ei_feature_t> features(2);
+    ei_dsp_scratch_array_t<std::unique_ptr<matrix_t>> matrix_ptrs(2);
+    if (features.get() == nullptr || matrix_ptrs.get() == nullptr)
+      return false;
+    matrix_ptrs[0] = std::unique_ptr<matrix_t>(new matrix_t(1, features_count));
+    if (matrix_ptrs[0]->buffer == nullptr)
+      return false;
+    features[0].matrix = matrix_ptrs[0].get();
+    memcpy(features[0].matrix->buffer, static_features_matrix.buffer, features_count * sizeof(float));
+    calc_cepstral_mean_and_var_normalization_mfcc(features[0].matrix, &mfcc_config);
+    ei_dsp_scratch_end();
+    windows.insert(windows.end(), features[0].matrix->buffer, features[0].matrix->buffer + features_count);
+  }
+  return true;
+}
+
+// Feed the audio slice by slice the way run_classifier_continuous() does,
+// resetting the arena after each one
+static bool run_slices(const std::vector<float> &audio, size_t arena_bytes, SliceRun &run)
+{
+  const size_t features_count = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE;
+  size_t features_written = 0;
+  std::vector<float> previous;
+
+  ei_dsp_clear_continuous_audio_state();
+  if (ei_dsp_scratch_init(arena_bytes) != 0)
+    return false;
+  run.windows.reserve(audio.size() / EI_CLASSIFIER_SLICE_SIZE * features_count);
+  previous.reserve(features_count);
+
+  for (size_t off = 0; off + EI_CLASSIFIER_SLICE_SIZE <= audio.size(); off += EI_CLASSIFIER_SLICE_SIZE)
+  {
+    g_audio = &audio[off];
+    signal_t signal;
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = &audio_get_data;
+
+    const float *rolling = nullptr;
+    size_t written_now = 0;
+    size_t allocs_before = heap_allocs;
+    if (!continuous_slice(&signal, features_written, rolling, written_now, run.windows))
+      return false;
+
+    run.live_at_reset += ei_dsp_scratch_live();
+    ei_dsp_scratch_reset();
+
+    if (run.slices++ >= SCRATCH_WARMUP_SLICES)
+      run.warm_allocs += heap_allocs - allocs_before;
+
+    // the older features only move down by what this slice wrote; anything
+    // else means the arena reused the rolling buffer's memory
+    if (!previous.empty() && written_now <= features_count &&
+        memcmp(rolling, previous.data() + written_now, (features_count - written_now) * sizeof(float)) != 0)
+      run.rolled_bad++;
+    previous.assign(rolling, rolling + features_count);
+  }
+
+  run.fallbacks = ei_dsp_scratch_fallbacks();
+  return true;
+}
+
+int run_scratch_check()
+{
+  bool ok = true;
+
+  ei_model_dsp_t block = {};
+  block.blockId = 10;
+  block.n_output_features = EI_CLASSIFIER_NN_INPUT_FRAME_SIZE;
+  block.extract_fn = &extract_mfcc_features;
+  block.config = &mfcc_config;
+  ei_impulse_t impulse = {};
+  impulse.frequency = EI_CLASSIFIER_FREQUENCY;
+  impulse.slice_size = EI_CLASSIFIER_SLICE_SIZE;
+  impulse.dsp_blocks = &block;
+  impulse.dsp_blocks_size = 1;
+  impulse.learning_blocks_size = 1;
+  const size_t arena_bytes = continuous_dsp_scratch_bytes(&impulse);
+
+  std::vector<float> audio = make_audio(8 * WINDOW_SAMPLES, 3);
+
+  SliceRun arena, heap;
+  if (!run_slices(audio, arena_bytes, arena))
+    return check(false, "scratch: continuous DSP with the arena");
+  size_t peak = ei_dsp_scratch_peak();
+  if (!run_slices(audio, 0, heap))
+    return check(false, "scratch: continuous DSP without the arena");
+  ei_dsp_scratch_init(0);
+
+  printf("scratch: %zu slices, %zu full windows, arena %zu bytes, peak %zu, %zu fallbacks, "
+         "%zu heap allocs after %d warmup slices (%zu without the arena)\n",
+         arena.slices, arena.windows.size() / EI_CLASSIFIER_NN_INPUT_FRAME_SIZE, arena_bytes, peak,
+         arena.fallbacks, arena.warm_allocs, SCRATCH_WARMUP_SLICES, heap.warm_allocs);
+  ok &= check(arena.warm_allocs == 0, "scratch: no heap allocations per slice once warmed up");
+  ok &= check(arena.fallbacks == 0 && peak <= arena_bytes, "scratch: every DSP temporary fits the arena");
+  ok &= check(arena.live_at_reset == 0, "scratch: no arena block outlives its slice");
+  ok &= check(arena.rolled_bad == 0 && heap.rolled_bad == 0, "scratch: rolling features survive every reset");
+  ok &= check(heap.warm_allocs > 0, "scratch: the counter sees heap allocations without the arena");
+  ok &= check(!arena.windows.empty() && arena.windows == heap.windows,
+              "scratch: every window matches the heap-only run bit for bit");
+
+  return ok ? 0 : 1;
+}
+
+// --- [melplan] cached mel filterbank and DCT plans vs building them per call -----
+
+struct MelConfig
+{
+  uint32_t frequency;
+  float frame_length, frame_stride;
+  uint8_t num_cepstral;
+  uint16_t num_filters, fft_length;
+  uint32_t low_frequency, high_frequency;
+  uint16_t version;
+};
+
+// the model's block (v4 and legacy v2) plus other shapes, so the cache has
+// to be rebuilt whenever the checks move to the next one. v2 defaults the
+// low edge to 300 Hz, so the v4 copy with 300 Hz differs only in version
+static const MelConfig mel_configs[] = {
+    {16000, 0.025f, 0.01f, 13, 32, 256, 0, 0, 4},
+    {16000, 0.025f, 0.01f, 13, 32, 256, 0, 0, 2},
+    {16000, 0.025f, 0.01f, 13, 32, 256, 300, 0, 4},
+    {16000, 0.02f, 0.02f, 13, 40, 512, 0, 0, 3},
+    {16000, 0.032f, 0.016f, 20, 40, 512, 80, 7600, 4},
+    {8000, 0.025f, 0.01f, 13, 26, 256, 0, 0, 4},
+};
+
+// feature::mfe as it was before the plan cache: mel points, bins and the
+// triangle weights are all worked out again on every call
+static int mfe_uncached(matrix_t *out_features, matrix_t *out_energies, signal_t *signal, const MelConfig &c)
+{
+  uint32_t low_frequency = c.low_frequency, high_frequency = c.high_frequency;
+  if (high_frequency == 0)
+    high_frequency = c.frequency / 2;
+  if (c.version < 4 && low_frequency == 0)
+    low_frequency = 300;
+
+  speechpy::stack_frames_info_t info;
+  info.signal = signal;
+  if (speechpy::processing::stack_frames(&info, c.frequency, c.frame_length, c.frame_stride, false, c.version) != 0)
+    return -1;
+  if (info.frame_ixs.size() != out_features->rows)
+    return -1;
+
+  const size_t spectrum_size = c.fft_length / 2 + 1;
+  const int mels_size = c.num_filters + 2;
+  std::vector<float> mels(mels_size);
+  std::vector<uint16_t> bins(mels_size);
+  numpy::linspace(speechpy::functions::frequency_to_mel((float)low_frequency),
+                  speechpy::functions::frequency_to_mel((float)high_frequency), mels_size, mels.data());
+  uint16_t max_bin = c.version >= 4 ? c.fft_length : spectrum_size;
+  for (int ix = 0; ix < mels_size - 1; ix++)
+  {
+    mels[ix] = speechpy::functions::mel_to_frequency(mels[ix]);
+    if (mels[ix] < low_frequency)
+      mels[ix] = low_frequency;
+    if (mels[ix] > high_frequency)
+      mels[ix] = high_frequency;
+    bins[ix] = speechpy::feature::get_fft_bin_from_hertz(max_bin, mels[ix], c.frequency);
+  }
+  mels[mels_size - 1] = speechpy::functions::mel_to_frequency(mels[mels_size - 1]);
+  if (mels[mels_size - 1] > high_frequency)
+    mels[mels_size - 1] = high_frequency;
+  mels[mels_size - 1] -= 0.001;
+  bins[mels_size - 1] = speechpy::feature::get_fft_bin_from_hertz(max_bin, mels[mels_size - 1], c.frequency);
+
+  std::vector<float> frame(info.frame_length), spectrum(spectrum_size);
+  for (size_t ix = 0; ix < info.frame_ixs.size(); ix++)
+  {
+    if (signal->get_data(info.frame_ixs[ix], info.frame_length, frame.data()) != 0)
+      return -1;
+    if (numpy::power_spectrum(frame.data(), info.frame_length, spectrum.data(), spectrum_size, c.fft_length) != 0)
+      return -1;
+    float energy = numpy::sum(spectrum.data(), spectrum_size);
+    out_energies->buffer[ix] = energy == 0 ? 1e-10 : energy;
+
+    float *row = out_features->get_row_ptr(ix);
+    for (size_t i = 0; i < c.num_filters; i++)
+    {
+      size_t left = bins[i], middle = bins[i + 1], right = bins[i + 2];
+      row[i] = spectrum[middle];
+      for (size_t bin = left + 1; bin < right; bin++)
+      {
+        if (bin < middle)
+          row[i] += ((static_cast<float>(bin) - left) / (middle - left)) * spectrum[bin];
+        if (bin > middle)
+          row[i] += ((right - static_cast<float>(bin)) / (right - middle)) * spectrum[bin];
+      }
+    }
+  }
+  numpy::zero_handling(out_features);
+  return 0;
+}
+
+// log mel energies of one window through mfe_uncached, shared by both DCTs below
+static bool log_mel_uncached(signal_t *signal, const MelConfig &c, matrix_t *mel, matrix_t *energy)
+{
+  if (mfe_uncached(mel, energy, signal, c) != 0)
+    return false;
+  return numpy::log(mel) == EIDSP_OK;
+}
+
+// DCT-II rows computed on the fly with the same formula and summing order
+// as the cached plan
+static void dct_uncached(const matrix_t *mel, const matrix_t *energy, const MelConfig &c, float *out)
+{
+  const double n_inv = 1.0 / c.num_filters;
+  for (size_t row = 0; row < mel->rows; row++)
+  {
+    const float *in = mel->buffer + row * mel->cols;
+    for (size_t k = 0; k < c.num_cepstral; k++)
+    {
+      double scale = 2.0 * sqrt((k == 0 ? 0.25 : 0.5) * n_inv);
+      float sum = 0;
+      for (size_t n = 0; n < c.num_filters; n++)
+        sum += static_cast<float>(scale * cos(M_PI * k * (2 * n + 1) * 0.5 * n_inv)) * in[n];
+      out[row * c.num_cepstral + k] = sum;
+    }
+    out[row * c.num_cepstral] = numpy::log(energy->buffer[row]); // DC elimination
+  }
+}
+
+// the FFT-based numpy::dct2 the plan replaced; not bit-exact, only close
+static bool dct_fft(const matrix_t *mel, const matrix_t *energy, const MelConfig &c, float *out)
+{
+  matrix_t m(mel->rows, mel->cols);
+  memcpy(m.buffer, mel->buffer, mel->rows * mel->cols * sizeof(float));
+  if (numpy::dct2(&m, DCT_NORMALIZATION_ORTHO) != EIDSP_OK)
+    return false;
+  for (size_t row = 0; row < m.rows; row++)
+  {
+    for (size_t k = 0; k < c.num_cepstral; k++)
+      out[row * c.num_cepstral + k] = m.buffer[row * m.cols + k];
+    out[row * c.num_cepstral] = numpy::log(energy->buffer[row]);
+  }
+  return true;
+}
+
+struct MelStats
+{
+  size_t windows = 0;
+  size_t mfe_diffs = 0;
+  size_t mfcc_diffs = 0;
+  double fft_worst = 0.0;
+};
+
+// One window in one config: cached mfe and mfcc against the uncached versions
+static bool check_mel_window(const float *audio, const MelConfig &c, MelStats &st)
+{
+  g_audio = audio;
+  signal_t signal;
+  signal.total_length = WINDOW_SAMPLES * c.frequency / EI_CLASSIFIER_FREQUENCY;
+  signal.get_data = &audio_get_data;
+
+  matrix_size_t size = speechpy::feature::calculate_mfe_buffer_size(
+      signal.total_length, c.frequency, c.frame_length, c.frame_stride, c.num_filters, c.version);
+  matrix_t mfe(size.rows, size.cols), mfe_energy(size.rows, 1);
+  matrix_t ref(size.rows, size.cols), ref_energy(size.rows, 1);
+  matrix_t mfcc(size.rows, c.num_cepstral);
+  std::vector<float> mfcc_ref(size.rows * c.num_cepstral), mfcc_fft(size.rows * c.num_cepstral);
+
+  if (speechpy::feature::mfe(&mfe, &mfe_energy, &signal, c.frequency, c.frame_length, c.frame_stride,
+                             c.num_filters, c.fft_length, c.low_frequency, c.high_frequency, c.version) != EIDSP_OK ||
+      speechpy::feature::mfcc(&mfcc, &signal, c.frequency, c.frame_length, c.frame_stride, c.num_cepstral,
+                              c.num_filters, c.fft_length, c.low_frequency, c.high_frequency, true, c.version) != EIDSP_OK ||
+      mfe_uncached(&ref, &ref_energy, &signal, c) != 0)
+    return false;
+
+  if (memcmp(mfe.buffer, ref.buffer, size.rows * size.cols * sizeof(float)) != 0 ||
+      memcmp(mfe_energy.buffer, ref_energy.buffer, size.rows * sizeof(float)) != 0)
+    st.mfe_diffs++;
+
+  if (!log_mel_uncached(&signal, c, &ref, &ref_energy))
+    return false;
+  dct_uncached(&ref, &ref_energy, c, mfcc_ref.data());
+  if (memcmp(mfcc.buffer, mfcc_ref.data(), mfcc_ref.size() * sizeof(float)) != 0)
+    st.mfcc_diffs++;
+
+  if (!dct_fft(&ref, &ref_energy, c, mfcc_fft.data()))
+    return false;
+  for (size_t i = 0; i < mfcc_fft.size(); i++)
+    st.fft_worst = fmax(st.fft_worst, fabs(mfcc.buffer[i] - mfcc_fft[i]) / fmax(1.0, fabs(mfcc_fft[i])));
+
+  st.windows++;
+  return true;
+}
+
+int run_melplan_check()
+{
+  bool ok = true;
+  const size_t configs = sizeof(mel_configs) / sizeof(mel_configs[0]);
+  std::vector<float> audio = make_audio(4 * WINDOW_SAMPLES, 7);
+
+  // Round-robin over the configs so every window after the first pass
+  // follows a different config (plans rebuilt), then repeat the model's
+  // config on the same audio (plans reused)
+  MelStats st;
+  for (size_t off = 0; off + WINDOW_SAMPLES <= audio.size(); off += WINDOW_SAMPLES / 2)
+    for (size_t ix = 0; ix < configs; ix++)
+      if (!check_mel_window(&audio[off], mel_configs[ix], st))
+        return check(false, "melplan: mfe/mfcc ran");
+  for (size_t off = 0; off + WINDOW_SAMPLES <= audio.size(); off += WINDOW_SAMPLES / 2)
+    for (int repeat = 0; repeat < 2; repeat++)
+      if (!check_mel_window(&audio[off], mel_configs[0], st))
+        return check(false, "melplan: mfe/mfcc ran");
+
+  printf("melplan: %zu windows in %zu configs, %zu mfe and %zu mfcc mismatches, worst rel err vs FFT dct2 %.2g\n",
+         st.windows, configs, st.mfe_diffs, st.mfcc_diffs, st.fft_worst);
+  ok &= check(st.mfe_diffs == 0, "melplan: cached mfe is bit-exact against the per-call filterbank");
+  ok &= check(st.mfcc_diffs == 0, "melplan: cached mfcc is bit-exact against the per-call DCT");
+  ok &= check(st.fft_worst < 1e-4, "melplan: mfcc stays within 1e-4 of the FFT-based dct2");
+
+  return ok ? 0 : 1;
+}
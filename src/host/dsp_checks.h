@@ -0,0 +1,13 @@
+#ifndef DSP_CHECKS_H
+#define DSP_CHECKS_H
+
+// Off-device checks of the voice DSP changes against straightforward
+// reference implementations. Each returns the process exit code (0 = pass).
+int run_cmvn_check();
+int run_scratch_check();
+int run_melplan_check();
+
+// Print one ok/FAIL line; returns ok (defined in sim_main.cpp)
+bool check(bool ok, const char *what);
+
+#endif // DSP_CHECKS_H
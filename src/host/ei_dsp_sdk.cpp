@@ -0,0 +1,8 @@
+// The handful of Edge Impulse SDK sources the DSP checks link against,
+// compiled straight into the native sim. [env:native] ignores the
+// inferencing library as a whole (TFLite, kernels, ports) and only adds its
+// include path, so these are pulled in here.
+#include "edge-impulse-sdk/dsp/memory.cpp"
+#include "edge-impulse-sdk/dsp/kissfft/kiss_fft.cpp"
+#include "edge-impulse-sdk/dsp/kissfft/kiss_fftr.cpp"
+#include "edge-impulse-sdk/dsp/dct/fast-dct-fft.cpp"
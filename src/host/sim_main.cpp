@@ -0,0 +1,477 @@
+// Headless simulator for the native (Linux) build: drives the game core with
+// a simple autopilot as fast as possible and reports throughput, so game-logic
+// changes can be regression-checked and benchmarked off-device.
+//
+//   pio run -e native
+//   .pio/build/native/program [ticks] [seed]          benchmark
+//   .pio/build/native/program record <games> <seed> <file>
+//   .pio/build/native/program replay <file>           re-simulate replays, check results
+//   .pio/build/native/program threads [seconds]       task-split scheduling test
+//   .pio/build/native/program tones                   buzzer sequencer checks
+//   .pio/build/native/program cmvn                    sliding-window cmvnw vs reference
+//   .pio/build/native/program scratch                 no heap use per voice slice
+//   .pio/build/native/program melplan                 cached mel/DCT plans vs per call
+//
+// Runs are deterministic: the same ticks and seed print the same results.
+// replay reads the same record format the device appends to /replays.bin.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "snake_game.h"
+#include "replay.h"
+#include "spsc_queue.h"
+#include "tasks.h"
+#include "tick_scheduler.h"
+#include "tone_sequencer.h"
+#include "dsp_checks.h"
+
+// Same grid as the default 240x300 playfield at CELL=10
+using SimGame = SnakeGame<24, 30, 10>;
+
+static SimGame game;
+
+// Greedy autopilot: prefer the free neighbour that gets closer to the food,
+// keep going straight otherwise. No reversals.
+static int8_t pick_direction(const SimGame &g)
+{
+  int8_t best = g.direction;
+  int bestDist = 1 << 30;
+  for (int8_t d = 0; d < 4; d++)
+  {
+    if (d == (g.direction + 2) % 4)
+      continue;
+    int nx = g.head_x + DIR_DX[d];
+    int ny = g.head_y + DIR_DY[d];
+    if (!SimGame::in_bounds(nx, ny) || g.cell_occupied(nx, ny))
+      continue;
+    int dist = abs(nx - g.food_x) + abs(ny - g.food_y);
+    if (dist < bestDist)
+    {
+      bestDist = dist;
+      best = d;
+    }
+  }
+  return best;
+}
+
+static void spawn_food()
+{
+  if (game.food_eaten)
+    game.spawn_food();
+}
+
+static int run_benchmark(unsigned long long ticks, uint32_t seed)
+{
+  // Each game gets its own seed from a master generator
+  SnakeRng seeds(seed);
+  game.reset(seeds.next());
+  spawn_food();
+
+  unsigned long games = 1;
+  unsigned long long totalScore = 0;
+  int bestScore = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned long long t = 0; t < ticks; t++)
+  {
+    game.queue_turn(pick_direction(game));
+    game.step();
+    if (game.game_over)
+    {
+      totalScore += game.score;
+      if (game.score > bestScore)
+        bestScore = game.score;
+      games++;
+      game.reset(seeds.next());
+    }
+    spawn_food();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  double secs = std::chrono::duration<double>(t1 - t0).count();
+  printf("ticks=%llu games=%lu avg_score=%.2f best_score=%d\n",
+         ticks, games, games > 1 ? (double)totalScore / (games - 1) : 0.0, bestScore);
+  printf("time=%.3fs  %.2f Mticks/s\n", secs, ticks / secs / 1e6);
+  return 0;
+}
+
+// Play autopilot games and write them as replay records
+static int run_record(unsigned long games, uint32_t seed, const char *path)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    perror(path);
+    return 1;
+  }
+
+  static ReplayRecorder<4096> rec;
+  SnakeRng seeds(seed);
+  for (unsigned long g = 0; g < games; g++)
+  {
+    game.reset(seeds.next());
+    rec.begin(game.seed);
+    spawn_food();
+    while (!game.game_over)
+    {
+      int8_t d = pick_direction(game);
+      if (d != game.direction && game.queue_turn(d))
+        rec.record(game.tick, REPLAY_TURN, d);
+      game.step();
+      spawn_food();
+    }
+    rec.finish(game.tick, REPLAY_END, game.score, game.snake_len);
+    fwrite(rec.data(), 1, rec.size(), f);
+    printf("game %lu seed=%08x score=%d ticks=%u bytes=%zu\n",
+           g, (unsigned)game.seed, game.score, (unsigned)game.tick, rec.size());
+  }
+  fclose(f);
+  return 0;
+}
+
+// Re-simulate every record in a replay file, unthrottled, and compare each
+// game's final score, length and tick with the ones recorded in its header.
+// Fails on any difference; truncated and version 1 records (no summary) are
+// replayed but can't be checked.
+static int run_replay(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+  {
+    perror(path);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+    data.insert(data.end(), chunk, chunk + n);
+  fclose(f);
+
+  ReplayPlayer<SimGame> player(game);
+  size_t pos = 0;
+  unsigned long count = 0, checked = 0, mismatched = 0;
+  while (pos + REPLAY_HEADER_SIZE <= data.size())
+  {
+    size_t recSize = ReplayReader::record_size(&data[pos]);
+    if (recSize == 0 || pos + recSize > data.size())
+    {
+      printf("bad record at offset %zu\n", pos);
+      return 1;
+    }
+    ReplayReader header(&data[pos], recSize);
+    if (!player.load(&data[pos], recSize))
+    {
+      printf("replay %lu: unreadable record\n", count);
+      return 1;
+    }
+    while (player.tick())
+      ;
+    printf("replay %lu seed=%08x score=%d len=%u ticks=%u over=%d",
+           count, (unsigned)game.seed, game.score, (unsigned)game.snake_len, (unsigned)game.tick, game.game_over);
+    if (header.has_summary() && !header.truncated())
+    {
+      bool same = game.score == header.final_score() && game.snake_len == header.final_length() &&
+                  game.tick == header.final_tick();
+      if (!same)
+      {
+        printf("  MISMATCH recorded score=%u len=%u ticks=%u", (unsigned)header.final_score(),
+               (unsigned)header.final_length(), (unsigned)header.final_tick());
+        mismatched++;
+      }
+      checked++;
+    }
+    printf("\n");
+    count++;
+    pos += recSize;
+  }
+  printf("replays=%lu checked=%lu mismatched=%lu\n", count, checked, mismatched);
+  return mismatched == 0 ? 0 : 1;
+}
+
+// Print one result line; returns ok so results can be and-ed together
+bool check(bool ok, const char *what)
+{
+  printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  return ok;
+}
+
+// Host version of the device task split: a game task ticking on a fixed
+// timestep and a voice task that blocks for a long "inference" before each
+// recognised command, connected by the same SPSC queue. Tick lateness must
+// stay within one tick however long inference takes, and no command may be
+// dropped; either fails the run.
+struct ThreadTest
+{
+  static constexpr uint32_t TICK_MS = 20; // well under the game's fastest (MIN_SPEED)
+  static constexpr uint32_t INFERENCE_MS = 250;
+
+  SpscQueue<uint8_t, 8> commands;
+  std::atomic<bool> stop{false};
+  std::atomic<uint32_t> sent{0};
+  std::atomic<uint32_t> lost{0};
+  uint32_t applied = 0;
+  TickScheduler ticker;
+};
+
+static uint32_t host_ms()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point t0 = steady_clock::now();
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now() - t0).count();
+}
+
+static void host_game_task(void *arg)
+{
+  ThreadTest &tt = *(ThreadTest *)arg;
+  game.reset(1);
+  spawn_food();
+  tt.ticker.start(host_ms(), ThreadTest::TICK_MS);
+  while (!tt.stop.load())
+  {
+    uint8_t dir;
+    while (tt.commands.pop(dir))
+    {
+      game.queue_turn(dir);
+      tt.applied++;
+    }
+    uint8_t due = tt.ticker.poll(host_ms(), ThreadTest::TICK_MS);
+    while (due-- > 0)
+    {
+      game.queue_turn(pick_direction(game));
+      game.step();
+      if (game.game_over)
+        game.reset(game.seed + 1);
+      spawn_food();
+    }
+    // same rule as the device game task: don't oversleep an imminent tick
+    if (tt.ticker.ms_until_next(host_ms()) > 1)
+      task_sleep_ms(1);
+  }
+}
+
+static void host_voice_task(void *arg)
+{
+  ThreadTest &tt = *(ThreadTest *)arg;
+  SnakeRng rng(7);
+  while (!tt.stop.load())
+  {
+    // stand-in for run_classifier(): blocks this task only. It sleeps rather
+    // than spins, because on the device inference has the other core to
+    // itself and a spin would compete with the game task on a small host
+    uint32_t until = host_ms() + ThreadTest::INFERENCE_MS;
+    while (host_ms() < until && !tt.stop.load())
+      task_sleep_ms(5);
+    if (tt.commands.push(rng.below(4)))
+      tt.sent++;
+    else
+      tt.lost++;
+  }
+}
+
+static int run_threads(uint32_t seconds)
+{
+  static ThreadTest tt;
+  start_pinned_task("game", host_game_task, &tt, 0, 2, 1);
+  start_pinned_task("voice", host_voice_task, &tt, 0, 1, 0);
+  task_sleep_ms(seconds * 1000);
+  tt.stop = true;
+  join_tasks();
+
+  // commands pushed after the game task's last drain are still delivered
+  uint8_t dir;
+  while (tt.commands.pop(dir))
+    tt.applied++;
+
+  const TickScheduler::Stats &js = tt.ticker.jitter();
+  printf("ticks=%u late_avg=%.2fms late_max=%ums dropped=%u commands sent=%u lost=%u applied=%u\n",
+         (unsigned)js.ticks, js.ticks ? (double)js.late_sum / js.ticks : 0.0,
+         (unsigned)js.late_max, (unsigned)js.dropped, (unsigned)tt.sent.load(),
+         (unsigned)tt.lost.load(), (unsigned)tt.applied);
+
+  bool ok = true;
+  ok &= check(js.ticks > 0, "threads: game task ticked");
+  ok &= check(js.late_max <= ThreadTest::TICK_MS && js.dropped == 0, "threads: no tick later than one period");
+  ok &= check(tt.lost.load() == 0 && tt.applied == tt.sent.load(), "threads: every command delivered");
+  return ok ? 0 : 1;
+}
+
+// Stand-in for the device buzzer: the esp_timer one-shot becomes a due
+// time on a simulated clock, and LEDC output a log of (start, freq).
+struct SimBuzzer
+{
+  ToneSequencer<32> seq;
+  uint32_t now = 0;
+  uint32_t due = 0;
+  bool armed = false;
+  std::vector<Note> log;
+  std::vector<uint32_t> starts;
+  uint16_t ledc = 0; // frequency the channel was last written with
+
+  void next_note()
+  {
+    Note n;
+    armed = seq.next(n);
+    if (!armed)
+    {
+      ledc = 0;
+      return;
+    }
+    ledc = n.freq;
+    log.push_back(n);
+    starts.push_back(now);
+    due = now + n.ms;
+  }
+
+  // like the device, an idle player is restarted by firing the timer now,
+  // not by starting the note from the caller
+  void play(const Note *notes, uint8_t count)
+  {
+    if (seq.play(notes, count))
+    {
+      armed = true;
+      due = now;
+    }
+  }
+
+  void advance(uint32_t ms)
+  {
+    uint32_t end = now + ms;
+    while (armed && due <= end)
+    {
+      now = due;
+      next_note();
+    }
+    now = end;
+  }
+};
+
+static int run_tones()
+{
+  bool ok = true;
+
+  // a whole game-over jingle queues instantly and then plays to its length
+  {
+    SimBuzzer b;
+    auto t0 = std::chrono::steady_clock::now();
+    b.play(NOTES_GAME_OVER, NOTE_COUNT(NOTES_GAME_OVER));
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    printf("play(game over) took %.2f us\n", us);
+    b.advance(2000);
+    ok &= check(b.log.size() == NOTE_COUNT(NOTES_GAME_OVER), "game over: every note played");
+    uint32_t len = 0;
+    for (const Note &n : NOTES_GAME_OVER)
+      len += n.ms;
+    ok &= check(b.starts.back() + b.log.back().ms == len, "game over: plays for the jingle's length");
+    ok &= check(b.seq.is_idle(), "game over: player idle afterwards");
+  }
+
+  // sounds started while one plays are appended, not lost or overlapped
+  {
+    SimBuzzer b;
+    b.play(NOTES_STARTUP, NOTE_COUNT(NOTES_STARTUP));
+    b.advance(50);
+    b.play(NOTES_CLICK, NOTE_COUNT(NOTES_CLICK));
+    b.advance(1000);
+    ok &= check(b.log.size() == 4 && b.log[3].freq == NOTES_CLICK[0].freq && b.starts[3] == 260,
+                "click during startup plays after it");
+    b.play(NOTES_EAT, NOTE_COUNT(NOTES_EAT));
+    b.advance(0);
+    ok &= check(b.starts.back() == 1050, "idle player restarts immediately");
+  }
+
+  // a sound started as the previous one ends is not silenced by the
+  // player going idle: all output comes from the player, in order
+  {
+    SimBuzzer b;
+    b.play(NOTES_EAT, NOTE_COUNT(NOTES_EAT));
+    b.advance(NOTES_EAT[0].ms);
+    b.play(NOTES_CLICK, NOTE_COUNT(NOTES_CLICK));
+    b.advance(0);
+    ok &= check(b.ledc == NOTES_CLICK[0].freq, "back-to-back: second sound keeps sounding");
+  }
+
+  // idle handshake under real concurrency: no note may be stranded in the
+  // queue with the player idle
+  {
+    static ToneSequencer<32> seq;
+    static std::atomic<uint32_t> kicks{0};
+    static std::atomic<uint32_t> played{0};
+    static std::atomic<bool> done{false};
+    static const Note blip = {1000, 0};
+
+    start_pinned_task("player", [](void *) {
+      uint32_t handled = 0;
+      while (!done.load() || handled != kicks.load())
+      {
+        if (handled == kicks.load())
+        {
+          task_sleep_ms(0);
+          continue;
+        }
+        handled++;
+        Note n;
+        while (seq.next(n))
+          played++;
+      } }, nullptr, 0, 1, 0);
+    start_pinned_task("game", [](void *) {
+      SnakeRng rng(3);
+      for (int i = 0; i < 200000; i++)
+      {
+        if (seq.play(&blip, 1))
+          kicks++;
+        // vary the gap so plays land at every point of the player's loop
+        for (volatile uint32_t spin = rng.below(64); spin > 0; spin--)
+          ;
+      }
+      done = true; }, nullptr, 0, 2, 1);
+    join_tasks();
+
+    Note n;
+    printf("concurrent: %u notes played, %u player starts\n", (unsigned)played.load(), (unsigned)kicks.load());
+    ok &= check(seq.is_idle() && !seq.next(n), "concurrent: nothing stranded");
+  }
+
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && strcmp(argv[1], "tones") == 0)
+    return run_tones();
+  if (argc > 1 && strcmp(argv[1], "cmvn") == 0)
+    return run_cmvn_check();
+  if (argc > 1 && strcmp(argv[1], "scratch") == 0)
+    return run_scratch_check();
+  if (argc > 1 && strcmp(argv[1], "melplan") == 0)
+    return run_melplan_check();
+  if (argc > 1 && strcmp(argv[1], "threads") == 0)
+    return run_threads(argc > 2 ? strtoul(argv[2], nullptr, 10) : 3);
+  if (argc > 1 && strcmp(argv[1], "record") == 0)
+  {
+    if (argc < 5)
+    {
+      fprintf(stderr, "usage: %s record <games> <seed> <file>\n", argv[0]);
+      return 2;
+    }
+    return run_record(strtoul(argv[2], nullptr, 10), strtoul(argv[3], nullptr, 0), argv[4]);
+  }
+  if (argc > 1 && strcmp(argv[1], "replay") == 0)
+  {
+    if (argc < 3)
+    {
+      fprintf(stderr, "usage: %s replay <file>\n", argv[0]);
+      return 2;
+    }
+    return run_replay(argv[2]);
+  }
+
+  unsigned long long ticks = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000ULL;
+  uint32_t seed = argc > 2 ? strtoul(argv[2], nullptr, 0) : 1;
+  return run_benchmark(ticks, seed);
+}
@@ -0,0 +1,137 @@
+#include "hud_view.h"
+#include "display.h"
+#include "compositor.h"
+#include "game.h"
+#include "buzzer.h"
+#include "font.h"
+
+// characters the HUD text can contain; anything else shows as a space
+static const char HUD_CHARS[] = " 0123456789:LVSCORE";
+#define HUD_GLYPHS (sizeof(HUD_CHARS) - 1)
+
+// text positions left of the pause icon (the last one may be clipped by it)
+#define HUD_TEXT_CHARS ((HUD_PAUSE_X - HUD_TEXT_X + HUD_GLYPH_W - 1) / HUD_GLYPH_W)
+
+static uint16_t atlas[HUD_GLYPHS][HUD_GLYPH_W * HUD_GLYPH_H];
+
+// What the HUD layer currently shows
+static bool hudDrawn = false;
+static char shownText[HUD_TEXT_CHARS];
+static bool shownPaused;
+static bool shownSound;
+
+static void drawThinHUDBorder(Adafruit_GFX &g) { g.drawRect(0, 0, SCREEN_W, HUD_H, ILI9341_WHITE); }
+
+static void drawPauseIcon(Adafruit_GFX &g, int x, int y) { 
+  g.fillRect(x, y, 6, 12, ILI9341_WHITE);
+  g.fillRect(x+10, y, 6, 12, ILI9341_WHITE);
+   /* you can fine tune */ }
+static void drawPlayIcon(Adafruit_GFX &g, int x, int y) { g.fillTriangle(x, y, x, y + 12, x + 10, y + 6, ILI9341_WHITE); }
+
+static void drawSpeakerOnIcon(Adafruit_GFX &g, int x, int y)
+{
+  // Speaker body (a small trapezoid/rectangle)
+  g.fillRect(x, y + 3, 4, 10, ILI9341_WHITE);               // rectangle part
+  g.fillTriangle(x + 4, y + 3, x + 4, y + 12, x + 9, y + 7, ILI9341_WHITE); // cone
+
+  // Sound waves (two arcs/curves)
+  g.drawLine(x + 11, y + 5, x + 13, y + 7, ILI9341_WHITE);
+  g.drawLine(x + 13, y + 7, x + 11, y + 10, ILI9341_WHITE);
+
+  g.drawLine(x + 15, y + 3, x + 18, y + 7, ILI9341_WHITE);
+  g.drawLine(x + 18, y + 7, x + 15, y + 12, ILI9341_WHITE);
+}
+
+static void drawSpeakerMutedIcon(Adafruit_GFX &g, int x, int y)
+{
+  // Base speaker (same as ON)
+  drawSpeakerOnIcon(g, x, y);
+
+  // Mute cross (X over the speaker)
+  g.drawLine(x, y, x + 18, y + 16, ILI9341_RED);
+  g.drawLine(x + 18, y, x, y + 16, ILI9341_RED);
+}
+
+void initHUD()
+{
+  // expand each glyph once from the 1-bpp font, white on HUD blue
+  for (uint8_t i = 0; i < HUD_GLYPHS; i++)
+    renderGlyph(HUD_CHARS[i], HUD_TEXT_SIZE, ILI9341_WHITE, ILI9341_BLUE, atlas[i], HUD_GLYPH_W);
+  hudDrawn = false;
+}
+
+static uint8_t glyph_index(char ch)
+{
+  const char *p = strchr(HUD_CHARS, ch);
+  return (p && ch) ? p - HUD_CHARS : 0;
+}
+
+// Copy one glyph into text position pos of the HUD layer and mark it dirty
+static void blit_glyph(GFXcanvas16 &hud, uint8_t pos, char ch)
+{
+  uint16_t *dst = hud.getBuffer();
+  if (!dst)
+    return;
+  int x = HUD_TEXT_X + pos * HUD_GLYPH_W;
+  int w = min(HUD_GLYPH_W, HUD_PAUSE_X - x);
+  const uint16_t *src = atlas[glyph_index(ch)];
+  for (int r = 0; r < HUD_GLYPH_H; r++)
+    memcpy(dst + (HUD_TEXT_Y + r) * SCREEN_W + x, src + r * HUD_GLYPH_W, w * sizeof(uint16_t));
+  compositorMarkDirty(x, HUD_TEXT_Y, w, HUD_GLYPH_H);
+}
+
+// Bring the HUD layer up to date with the game state; only what changed is
+// redrawn (and later flushed by the compositor)
+void draw_HUD()
+{
+  GFXcanvas16 &hud = hudCanvas();
+
+  if (!hudDrawn)
+  {
+    hud.fillRect(0, 0, SCREEN_W, HUD_H, ILI9341_BLUE);
+    drawThinHUDBorder(hud);
+    compositorMarkDirty(0, 0, SCREEN_W, HUD_H);
+    memset(shownText, ' ', sizeof(shownText));
+    shownPaused = !game.paused;
+    shownSound = !sound_enabled;
+    hudDrawn = true;
+  }
+
+  char text[HUD_TEXT_CHARS + 1];
+  int len = snprintf(text, sizeof(text), "LVL:%d SCORE:%d", game.level, game.score);
+  if (len > HUD_TEXT_CHARS)
+    len = HUD_TEXT_CHARS;
+  for (uint8_t i = 0; i < HUD_TEXT_CHARS; i++)
+  {
+    char ch = i < len ? text[i] : ' ';
+    if (ch != shownText[i])
+    {
+      blit_glyph(hud, i, ch);
+      shownText[i] = ch;
+    }
+  }
+
+  // pause/play icon
+  if (game.paused != shownPaused)
+  {
+    hud.fillRect(HUD_PAUSE_X, 2, 20, HUD_H - 4, ILI9341_BLUE);
+    if (game.paused)
+      drawPlayIcon(hud, HUD_PAUSE_X, 2);
+    else
+      drawPauseIcon(hud, HUD_PAUSE_X, 2);
+    compositorMarkDirty(HUD_PAUSE_X, 2, 20, HUD_H - 4);
+    shownPaused = game.paused;
+  }
+
+  // sound icon (the mute cross reaches one row lower than the speaker)
+  if (sound_enabled != shownSound)
+  {
+    hud.fillRect(HUD_SOUND_X, 2, 26, HUD_H - 3, ILI9341_BLUE);
+    if (sound_enabled)
+      drawSpeakerOnIcon(hud, SCREEN_W - 20, 2);
+    else
+      drawSpeakerMutedIcon(hud, SCREEN_W - 20, 2);
+    compositorMarkDirty(HUD_SOUND_X, 2, 26, HUD_H - 3);
+    shownSound = sound_enabled;
+  }
+}
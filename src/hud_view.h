@@ -0,0 +1,22 @@
+#ifndef HUD_VIEW_H
+#define HUD_VIEW_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "font.h"
+
+// Incremental HUD: remembers what is on the HUD layer and only touches the
+// characters and icons that changed since the last draw_HUD(). Text comes
+// from a glyph atlas expanded from the font once at startup, so an
+// unchanged HUD costs no drawing and no SPI traffic.
+#define HUD_TEXT_X     4
+#define HUD_TEXT_Y     2
+#define HUD_TEXT_SIZE  2
+#define HUD_GLYPH_W    (FONT_CELL_W * HUD_TEXT_SIZE)
+#define HUD_GLYPH_H    (FONT_CELL_H * HUD_TEXT_SIZE)
+#define HUD_PAUSE_X    (SCREEN_W - 60)
+#define HUD_SOUND_X    (SCREEN_W - 28)
+
+void initHUD(); // call after the compositor's HUD canvas exists (initDisplay)
+
+#endif // HUD_VIEW_H
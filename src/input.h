@@ -0,0 +1,26 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <Arduino.h>
+
+// A user command from any source (WebSocket, voice, IR), applied by the
+// game task through applyInput().
+enum InputType : uint8_t
+{
+  INPUT_DIRECTION,  // arg = 0..3 (Up, Right, Down, Left)
+  INPUT_PAUSE,
+  INPUT_RESTART,
+  INPUT_MUTE,
+  INPUT_REPLAY
+};
+
+struct InputEvent
+{
+  InputType type;
+  uint8_t arg;
+};
+
+// Apply one command in the game task (defined in main.cpp)
+void applyInput(const InputEvent &ev);
+
+#endif // INPUT_H
@@ -13,31 +13,32 @@ void initIR()
   Serial.println("IR receiver initialized");
 }
 
-// Call this regularly from loop()
+// Call this regularly from the game task
 void handleIRInput()
 {
   if (IrReceiver.decode()) {
     uint32_t irCode = IrReceiver.decodedIRData.decodedRawData;
     Serial.print("IR Code: 0x"); Serial.println(irCode, HEX);
 
-    if (irCode == IR_UP_CODE && direction != 2) {
-      direction = 0;
+    // turns are queued; the game rejects reversals against the applied direction
+    if (irCode == IR_UP_CODE) {
+      game_turn(0);
       playClickBeep();
     }
-    else if (irCode == IR_DOWN_CODE && direction != 0) {
-      direction = 2;
+    else if (irCode == IR_DOWN_CODE) {
+      game_turn(2);
       playClickBeep();
     }
-    else if (irCode == IR_LEFT_CODE && direction != 1) {
-      direction = 3;
+    else if (irCode == IR_LEFT_CODE) {
+      game_turn(3);
       playClickBeep();
     }
-    else if (irCode == IR_RIGHT_CODE && direction != 3) {
-      direction = 1;
+    else if (irCode == IR_RIGHT_CODE) {
+      game_turn(1);
       playClickBeep();
     }
     else if (irCode == IR_PAUSE_CODE) {
-      paused = !paused;
+      game_toggle_pause();
       playClickBeep();
       draw_frame();
     }
@@ -6,8 +6,27 @@
 #include "web_control.h"
 #include "buzzer.h"
 #include "voice.h"
-
-unsigned long lastMove = 0;
+#include "replay_log.h"
+#include "input.h"
+#include "tasks.h"
+
+// log tick jitter every this many ticks
+constexpr uint32_t JITTER_LOG_TICKS = 1000;
+
+// Task layout: game ticks, input and all TFT drawing run on the app core;
+// WebSocket housekeeping and voice inference run on the protocol core next to
+// the WiFi stack. Commands cross over only through the SPSC queues drained at
+// the top of gameLoopOnce(), so a tick never waits on run_classifier().
+#define GAME_TASK_CORE        1
+#define GAME_TASK_PRIORITY    2
+#define GAME_TASK_STACK       8192
+#define NETVOICE_TASK_CORE    0
+#define NETVOICE_TASK_PRIORITY 1
+#define NETVOICE_TASK_STACK   16384
+#define WS_CLEANUP_MS         1000
+
+static void gameTask(void *arg);
+static void netVoiceTask(void *arg);
 
 void setup()
 {
@@ -20,94 +39,140 @@ void setup()
   initWebSocket();
   initWebServer();
 
-  pinMode(BUZZER_PIN, OUTPUT);
+  initBuzzer();
 
   initIR();
 
   initVoice(); // initialize EI runner and voice subsystem
 
   restart_with_splash();
+
+  start_pinned_task("game", gameTask, nullptr, GAME_TASK_STACK, GAME_TASK_PRIORITY, GAME_TASK_CORE);
+  start_pinned_task("netvoice", netVoiceTask, nullptr, NETVOICE_TASK_STACK, NETVOICE_TASK_PRIORITY, NETVOICE_TASK_CORE);
 }
 
-void loop()
+// Apply one user command in the game task. Direction, pause and mute give
+// click + HUD feedback.
+void applyInput(const InputEvent &ev)
 {
-  wsCleanupClients();
-  handleIRInput(); // IR remote check
-
-  // run on-device voice inference (Edge Impulse)
-  voiceLoop();
-
-  if (!paused && !game_over)
+  switch (ev.type)
   {
-    unsigned long now = millis();
-    if (now - lastMove >= (unsigned long)snake_speed)
-    {
-      lastMove = now;
-      move_snake();
-      if (food_eaten)
-        safeSpawnFood();
-      draw_frame();
-    }
+  case INPUT_DIRECTION:
+    game_turn(ev.arg);
+    break;
+  case INPUT_PAUSE:
+    game_toggle_pause();
+    break;
+  case INPUT_MUTE:
+    sound_enabled = !sound_enabled;
+    break;
+  case INPUT_RESTART:
+    restart_with_splash();
+    return;
+  case INPUT_REPLAY:
+    replayStartLast();
+    return;
   }
-  else
+
+  playClickBeep();
+  draw_frame();
+}
+
+// One iteration of the game task: input, due ticks, drawing
+static void gameLoopOnce()
+{
+  handleIRInput(); // IR remote check
+
+  // drain every command the AsyncTCP and voice tasks queued since last time
+  InputEvent ev;
+  while (wsPollEvent(ev))
+    applyInput(ev);
+  while (voicePollEvent(ev))
+    applyInput(ev);
+
+  // Fixed-timestep ticks: the scheduler reports how many ticks are due, so
+  // time lost to blocking work is caught up instead of delaying the cadence.
+  static bool wasRunning = false;
+  unsigned long now = millis();
+
+  // splash/countdown steps; the game starts when it ends and no ticks run
+  // meanwhile
+  if (splashActive() && splashUpdate(now))
+    start_game();
+  bool running = !game.paused && !game.game_over && !splashActive();
+  if (running)
   {
-    static unsigned long lastRedraw = 0;
-    if (millis() - lastRedraw > 200)
+    if (!wasRunning)
+      ticker.start(now, game.snake_speed); // resuming: don't catch up paused time
+
+    uint8_t due = ticker.poll(now, game.snake_speed);
+    bool moved = false;
+    while (due-- > 0 && !game.paused && !game.game_over)
     {
-      if (game_over)
-        draw_game_over_screen();
+      if (replayPlaying())
+      {
+        replayTick();
+      }
       else
-        draw_frame();
-      lastRedraw = millis();
+      {
+        move_snake();
+        if (game.food_eaten)
+          safeSpawnFood();
+      }
+      moved = true;
     }
-  }
-
-  // handle actions requested by web socket (run in main context)
-  if (ws_setDirection >= 0)
-  {
-    direction = ws_setDirection;
-    ws_setDirection = -1;
-  }
+    if (moved)
+      draw_frame();
 
-  if (ws_togglePause)
-  {
-    ws_togglePause = false;
-    paused = !paused;
+    const TickScheduler::Stats &js = ticker.jitter();
+    if (js.ticks >= JITTER_LOG_TICKS)
+    {
+      Serial.printf("Tick jitter: avg=%lums max=%lums dropped=%lu over %lu ticks\n",
+                    (unsigned long)(js.late_sum / js.ticks), (unsigned long)js.late_max,
+                    (unsigned long)js.dropped, (unsigned long)js.ticks);
+      ticker.reset_jitter();
+    }
   }
 
-  if (ws_toggleSound)
-  {
-    ws_toggleSound = false;
-    sound_enabled = !sound_enabled;
-  }
+  wasRunning = !game.paused && !game.game_over && !splashActive();
 
-  if (ws_needBeep)
-  {
-    ws_needBeep = false;
-    playClickBeep();
-  }
+  // Draw only if the scene version moved (paused and game-over screens are
+  // not repainted), in one SPI transaction
+  present_frame();
 
-  if (ws_needRedraw)
-  {
-    ws_needRedraw = false;
-    draw_frame();
-  }
+  // Only sleep when the next tick is not imminent; a tick is never delayed
+  // by more than the 1 ms this gives the idle task. Paused, game over and
+  // splash have no next tick (the scheduler reports 0), so always sleep then
+  // or this task would spin its core.
+  if (!wasRunning || ticker.ms_until_next(millis()) > 1)
+    task_sleep_ms(1);
+}
 
-  if (ws_needRestart)
-  {
-    ws_needRestart = false;
-    restart_with_splash();
-  }
+static void gameTask(void *arg)
+{
+  for (;;)
+    gameLoopOnce();
+}
 
-  // WINDOW: if the web client sent a transcript via "VOICE:<transcript>" then
-  // main loop picks it up and calls the text->action mapping function.
-  if (ws_voiceCommand)
+// WebSocket client cleanup plus voice: transcripts from the browser and
+// on-device Edge Impulse inference, which may block this task for a long time
+static void netVoiceTask(void *arg)
+{
+  unsigned long lastCleanup = 0;
+  for (;;)
   {
-    // clear flag first to avoid races
-    ws_voiceCommand = false;
-    handleVoiceCommand(ws_voiceTranscript);
-    ws_voiceTranscript = "";
+    if (millis() - lastCleanup >= WS_CLEANUP_MS)
+    {
+      wsCleanupClients();
+      lastCleanup = millis();
+    }
+    voiceLoop();
+    task_sleep_ms(1);
   }
+}
 
-  delay(10);
+// Everything runs in the pinned tasks started by setup()
+void loop()
+{
+  vTaskDelete(NULL);
 }
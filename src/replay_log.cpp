@@ -0,0 +1,116 @@
+#include "replay_log.h"
+#include "game.h"
+#include "display.h"
+#include "compositor.h"
+#include "SPIFFS.h"
+
+static ReplayRecorder<REPLAY_BUF_SIZE> recorder;
+static ReplayPlayer<Game> player(game);
+static uint8_t playBuf[REPLAY_BUF_SIZE];
+
+void replayBegin(uint32_t seed)
+{
+  if (player.is_running()) return;
+  recorder.begin(seed);
+}
+
+void replayRecord(ReplayEventType type, uint8_t arg)
+{
+  if (player.is_running()) return;
+  recorder.record(game.tick, type, arg);
+}
+
+void replayFinish(ReplayEventType type)
+{
+  if (!recorder.is_active()) return;
+  recorder.finish(game.tick, type, game.score, game.snake_len);
+
+  File f = SPIFFS.open(REPLAY_FILE, FILE_APPEND);
+  if (!f) {
+    Serial.println("[Replay] open failed");
+    return;
+  }
+  if (f.size() + recorder.size() > REPLAY_FILE_MAX) {
+    // rotate: drop the old log rather than fill the filesystem
+    f.close();
+    SPIFFS.remove(REPLAY_FILE);
+    f = SPIFFS.open(REPLAY_FILE, FILE_APPEND);
+    if (!f) return;
+  }
+  f.write(recorder.data(), recorder.size());
+  f.close();
+  Serial.printf("[Replay] saved %u bytes (seed %08lx, %lu ticks)\n",
+                (unsigned)recorder.size(), (unsigned long)game.seed, (unsigned long)game.tick);
+}
+
+// Find the last complete record in the replay file and load it into playBuf
+static size_t loadLastReplay()
+{
+  File f = SPIFFS.open(REPLAY_FILE, FILE_READ);
+  if (!f) return 0;
+
+  size_t fileSize = f.size();
+  size_t pos = 0, lastPos = 0, lastSize = 0;
+  uint8_t hdr[REPLAY_HEADER_SIZE];
+  while (pos + REPLAY_HEADER_SIZE <= fileSize) {
+    f.seek(pos);
+    if (f.read(hdr, sizeof(hdr)) != sizeof(hdr)) break;
+    size_t recSize = ReplayReader::record_size(hdr);
+    if (recSize == 0 || pos + recSize > fileSize) break; // corrupt or partial tail
+    lastPos = pos;
+    lastSize = recSize;
+    pos += recSize;
+  }
+
+  if (lastSize == 0 || lastSize > sizeof(playBuf)) {
+    f.close();
+    return 0;
+  }
+  f.seek(lastPos);
+  size_t n = f.read(playBuf, lastSize);
+  f.close();
+  return n == lastSize ? n : 0;
+}
+
+bool replayStartLast()
+{
+  // load and check the last saved game first; on failure the live game
+  // keeps running and recording as if nothing happened
+  size_t n = loadLastReplay();
+  if (n == 0) {
+    Serial.println("[Replay] nothing to play");
+    return false;
+  }
+  if (!ReplayReader(playBuf, n).ok()) {
+    Serial.println("[Replay] bad record");
+    return false;
+  }
+
+  // playback replaces the live game, which is saved like any other restart
+  // (after the load, so it isn't the game that gets played back)
+  replayFinish(REPLAY_RESTART);
+
+  splashCancel(); // replaces a running countdown
+  compositorClearCells();
+  player.load(playBuf, n);
+  Serial.printf("[Replay] playing seed %08lx\n", (unsigned long)game.seed);
+  compositorInvalidate(); // may be coming from the game-over page
+  draw_frame();
+  ticker.start(millis(), game.snake_speed);
+  return true;
+}
+
+bool replayPlaying() { return player.is_running(); }
+
+void replayStop() { player.stop(); }
+
+void replayTick()
+{
+  if (player.tick()) return;
+  Serial.println("[Replay] finished");
+  if (!game.game_over) {
+    // replay ended on a restart: end the replayed game rather than let it run live
+    game.game_over = true;
+    draw_frame();
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <Arduino.h>
+#include "replay.h"
+
+// Every game is recorded (seed + inputs) and appended to SPIFFS when it ends.
+// The file is a plain concatenation of replay records (see replay.h).
+#define REPLAY_FILE      "/replays.bin"
+#define REPLAY_FILE_MAX  65536 // start a fresh file once it grows past this
+#define REPLAY_BUF_SIZE  1024  // per-game recording buffer
+
+// Recording (no-ops while a replay is playing back)
+void replayBegin(uint32_t seed);
+void replayRecord(ReplayEventType type, uint8_t arg = 0);
+void replayFinish(ReplayEventType type); // closes the game and appends it to SPIFFS
+
+// Wall-clock playback of the most recent saved game on the TFT
+bool replayStartLast();
+bool replayPlaying();
+void replayStop();
+void replayTick(); // one playback tick; call at game.snake_speed cadence
+
+#endif // REPLAY_LOG_H
@@ -0,0 +1,73 @@
+#include "sprites.h"
+#include "display.h"
+
+#include <Adafruit_GFX.h>
+
+// 10 sprites x 100 px x 2 bytes = 2 KB with the default 10 px cell
+static uint16_t sprite_px[SPRITE_COUNT][CELL * CELL];
+
+static void render_head(GFXcanvas16 &c, uint8_t dir)
+{
+  c.fillRect(0, 0, CELL, CELL, ILI9341_GREEN);
+
+  // two eyes near the leading edge
+  int e = max(1, (int)CELL / 5);
+  int front = (dir == 0 || dir == 3) ? 2 : CELL - 2 - e;
+  int s1 = 2, s2 = CELL - 2 - e;
+  if (dir == 0 || dir == 2)
+  {
+    c.fillRect(s1, front, e, e, ILI9341_BLACK);
+    c.fillRect(s2, front, e, e, ILI9341_BLACK);
+  }
+  else
+  {
+    c.fillRect(front, s1, e, e, ILI9341_BLACK);
+    c.fillRect(front, s2, e, e, ILI9341_BLACK);
+  }
+}
+
+static void render_body(GFXcanvas16 &c, uint8_t dir)
+{
+  c.fillRoundRect(0, 0, CELL, CELL, 2, ILI9341_YELLOW);
+
+  // square the corners on the side joining the next segment headwards
+  int h = CELL / 2;
+  switch (dir)
+  {
+  case 0: c.fillRect(0, 0, CELL, h, ILI9341_YELLOW); break;
+  case 1: c.fillRect(h, 0, CELL - h, CELL, ILI9341_YELLOW); break;
+  case 2: c.fillRect(0, h, CELL, CELL - h, ILI9341_YELLOW); break;
+  case 3: c.fillRect(0, 0, h, CELL, ILI9341_YELLOW); break;
+  }
+}
+
+static void render_fruit(GFXcanvas16 &c)
+{
+  int r = max(1, (int)CELL / 2);
+  c.fillCircle(CELL / 2, CELL / 2, r - 1, ILI9341_WHITE);
+}
+
+void initSprites()
+{
+  // one scratch canvas, drawn with the normal GFX primitives and copied out
+  GFXcanvas16 canvas(CELL, CELL);
+  for (uint8_t id = 0; id < SPRITE_COUNT; id++)
+  {
+    canvas.fillScreen(ILI9341_BLACK);
+    if (id == SPRITE_FRUIT)
+      render_fruit(canvas);
+    else if (id >= SPRITE_BODY)
+      render_body(canvas, id - SPRITE_BODY);
+    else if (id >= SPRITE_HEAD)
+      render_head(canvas, id - SPRITE_HEAD);
+
+    const uint16_t *src = canvas.getBuffer();
+    if (src)
+      memcpy(sprite_px[id], src, sizeof(sprite_px[id]));
+  }
+}
+
+const uint16_t *sprite_pixels(SpriteId id)
+{
+  return sprite_px[id];
+}
@@ -0,0 +1,27 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Playfield cells pre-rendered once into CELL x CELL RGB565 buffers; the
+// compositor copies their rows straight into the pixel stream instead of
+// drawing a stack of GFX primitives per cell. Head and body come in one
+// variant per direction (0..3, same convention as the game core).
+enum SpriteId : uint8_t
+{
+  SPRITE_EMPTY = 0,
+  SPRITE_FRUIT = 1,
+  SPRITE_HEAD = 2, // + direction of travel (eyes look that way)
+  SPRITE_BODY = 6, // + direction towards the head (that side is squared off)
+  SPRITE_COUNT = 10
+};
+
+inline SpriteId head_sprite(uint8_t dir) { return (SpriteId)(SPRITE_HEAD + (dir & 3)); }
+inline SpriteId body_sprite(uint8_t dir) { return (SpriteId)(SPRITE_BODY + (dir & 3)); }
+
+void initSprites(); // call once after tft.begin()
+
+const uint16_t *sprite_pixels(SpriteId id);
+
+#endif // SPRITES_H
@@ -1,7 +1,9 @@
 #include "voice.h"
 #include "web_control.h" // share ws flags and notifyClients()
 #include "buzzer.h"
+#include "spsc_queue.h"
 #include <Arduino.h>
+#include <atomic>
 
 
 #ifdef EI_PORTING_ARDUINO
@@ -9,133 +11,213 @@
 #endif
 #define EI_PORTING_ARDUINO 1
 
+// Continuous inference: the 1 s model window is fed as 4 slices of 250 ms,
+// and each run only computes MFCC for the newest slice (must be set before
+// the EI include)
+#define EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW 4
+
 #include "snake-voice-console_inferencing.h"
 
-// Buffer to accumulate incoming PCM16 samples from browser stream.
-// We'll accumulate up to EI_CLASSIFIER_RAW_SAMPLE_COUNT samples (model window).
-static volatile int16_t *g_buffer = nullptr;
-static volatile size_t g_buf_write = 0;
-static volatile size_t g_buf_count = 0;
-static volatile bool g_ready_for_inference = false;
+// Incoming PCM16 from the browser stream is cut into slices. Slice buffers
+// circulate between the AsyncTCP task (fills them) and the net/voice task
+// (classifies them) through two SPSC queues, so neither side ever waits:
+//   voiceFreeSlices:  voice task -> AsyncTCP, empty buffers
+//   voiceReadySlices: AsyncTCP -> voice task, full buffers in stream order
+// When all buffers are busy the audio is dropped, which caps inference at
+// one run per slice of audio however far the classifier falls behind.
+struct VoiceSlice
+{
+  uint8_t buf;
+  bool afterGap; // audio was lost before this slice; restart the window
+};
+
+static int16_t *g_slices = nullptr; // VOICE_SLICE_BUFFERS x EI_CLASSIFIER_SLICE_SIZE
+static std::atomic<bool> g_voiceReady{false};
+static SpscQueue<uint8_t, 4> voiceFreeSlices;
+static SpscQueue<VoiceSlice, 4> voiceReadySlices;
+static_assert(VOICE_SLICE_BUFFERS <= 4, "both slice queues must hold every buffer");
+
+// producer (AsyncTCP task) state
+static int8_t g_fillBuf = -1;
+static size_t g_fillCount = 0;
+static bool g_fillGap = true;
+static unsigned long g_lastFeedMs = 0;
+
+// consumer (net/voice task) state
+static const int16_t *g_inferSlice = nullptr;
+static float g_maf[VOICE_MAF_LEN][EI_CLASSIFIER_LABEL_COUNT];
+static uint8_t g_mafPos = 0;
+static uint8_t g_warmup = 0;   // slices left before the model window is full
+static uint8_t g_cooldown = 0; // slices left before another command may fire
+
+static SpscQueue<InputEvent, VOICE_EVENT_QUEUE_LEN> voiceEvents;
+
+void voicePushInput(const InputEvent &ev)
+{
+  if (!voiceEvents.push(ev))
+    Serial.println("[Voice] event queue full, dropped");
+}
+
+bool voicePollEvent(InputEvent &ev) { return voiceEvents.pop(ev); }
 
 // allocate on init
 void initVoice() {
-  // allocate circular buffer of RAW_SAMPLE_COUNT
-  size_t capacity = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
-  g_buffer = (int16_t*)malloc(sizeof(int16_t) * capacity);
-  if (!g_buffer) {
+  g_slices = (int16_t*)malloc(sizeof(int16_t) * EI_CLASSIFIER_SLICE_SIZE * VOICE_SLICE_BUFFERS);
+  if (!g_slices) {
     Serial.println("[Voice] failed to allocate audio buffer");
     return;
   }
-  memset((void*)g_buffer, 0, sizeof(int16_t) * capacity);
-  g_buf_write = 0;
-  g_buf_count = 0;
-  g_ready_for_inference = false;
+  for (uint8_t i = 0; i < VOICE_SLICE_BUFFERS; i++)
+    voiceFreeSlices.push(i);
+
+  run_classifier_init();
+
+  // publish last: web_control may already be delivering audio
+  g_voiceReady.store(true, std::memory_order_release);
 
-  randomSeed(millis());
-  Serial.println("[Voice] Initialized (streaming -> EI)");
+  Serial.printf("[Voice] Initialized (streaming -> EI, %d slices of %d samples)\n",
+                EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW, EI_CLASSIFIER_SLICE_SIZE);
 }
 
 /**
  * Called from web_control when it receives binary frames (PCM16 LE)
+ * Runs on the AsyncTCP task; only copies samples into the current slice.
  */
 void microphone_feed(const int16_t *samples, size_t count) {
-  if (!g_buffer) return;
-  const size_t capacity = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
-
-  // append samples into circular buffer; maintain count as min(capacity, running_count)
-  for (size_t i = 0; i < count; i++) {
-    g_buffer[g_buf_write] = samples[i];
-    g_buf_write++;
-    if (g_buf_write >= capacity) g_buf_write = 0;
-    if (g_buf_count < capacity) g_buf_count++;
-  }
+  if (!g_voiceReady.load(std::memory_order_acquire)) return;
 
-  // if we have a full window, mark ready (we will run classifier in voiceLoop)
-  if (g_buf_count >= capacity) {
-    g_ready_for_inference = true;
+  // the browser stopped streaming for a while: don't glue old and new audio
+  unsigned long now = millis();
+  if (now - g_lastFeedMs > VOICE_STREAM_GAP_MS) {
+    g_fillCount = 0;
+    g_fillGap = true;
+  }
+  g_lastFeedMs = now;
+
+  while (count > 0) {
+    if (g_fillBuf < 0) {
+      uint8_t b;
+      if (!voiceFreeSlices.pop(b)) {
+        // classifier is behind: drop this audio and restart the window later
+        g_fillGap = true;
+        return;
+      }
+      g_fillBuf = b;
+      g_fillCount = 0;
+    }
+
+    int16_t *dst = g_slices + (size_t)g_fillBuf * EI_CLASSIFIER_SLICE_SIZE;
+    size_t n = EI_CLASSIFIER_SLICE_SIZE - g_fillCount;
+    if (n > count) n = count;
+    memcpy(dst + g_fillCount, samples, n * sizeof(int16_t));
+    g_fillCount += n;
+    samples += n;
+    count -= n;
+
+    if (g_fillCount == EI_CLASSIFIER_SLICE_SIZE) {
+      // can't fail: the queue has a slot for every buffer
+      voiceReadySlices.push({(uint8_t)g_fillBuf, g_fillGap});
+      g_fillBuf = -1;
+      g_fillGap = false;
+    }
   }
 }
 
 /**
  * signal.get_data callback for EI API.
- * Converts the circular int16 buffer into float samples for the classifier.
- * offset: offset in the signal window to read
- * length: how many samples to write into out_ptr
+ * Converts the slice being classified into float samples.
  */
 static int ei_signal_get_data(size_t offset, size_t length, float *out_ptr) {
-  const size_t capacity = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
-  // Determine start index: the classifier expects data in [0 .. window-1].
-  // Map that to our circular buffer where g_buf_write points to next write.
-  // The last capacity samples are the window. The start index for sample 0 is:
-  size_t start;
-  if (g_buf_write >= capacity) start = g_buf_write - capacity;
-  else start = (capacity + g_buf_write) - capacity; // effectively 0
-
-  // But since g_buf_write always in [0,capacity), the window start is (g_buf_write) position as the next write.
-  // The last 'capacity' samples occupy indices (g_buf_write .. g_buf_write+capacity-1) modulo capacity.
-  // For offset x, index = (g_buf_write + offset) % capacity
-  for (size_t i = 0; i < length; i++) {
-    size_t idx = (g_buf_write + offset + i) % capacity;
-    int16_t v = g_buffer[idx];
-    out_ptr[i] = (float)v / 32768.0f;
-  }
+  for (size_t i = 0; i < length; i++)
+    out_ptr[i] = (float)g_inferSlice[offset + i] / 32768.0f;
   return 0;
 }
 
+// Start over with an empty model window (stream start or lost audio)
+static void reset_continuous() {
+  run_classifier_init();
+  memset(g_maf, 0, sizeof(g_maf));
+  g_mafPos = 0;
+  g_warmup = EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW - 1;
+  g_cooldown = 0;
+}
+
+// Background classes never trigger a command
+static bool is_background_label(const char *label) {
+  return strcmp(label, "noice") == 0 || strcmp(label, "silence") == 0;
+}
+
 /**
- * Convert model results -> call handleVoiceCommand (re-uses your mapping)
+ * Smooth the scores over the last VOICE_MAF_LEN slices, then map the winner
+ * to a command (re-uses handleVoiceCommand's mapping)
  */
 static void process_classification(ei_impulse_result_t *result) {
+  for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++)
+    g_maf[g_mafPos][i] = result->classification[i].value;
+  g_mafPos = (g_mafPos + 1) % VOICE_MAF_LEN;
+
+  // the window still holds audio from before the stream (re)started
+  if (g_warmup > 0) { g_warmup--; return; }
+  // the word that fired the last command is still inside the window
+  if (g_cooldown > 0) { g_cooldown--; return; }
+
   // find the highest scoring label
   float best_score = 0.0f;
   size_t best_ix = SIZE_MAX;
   for (size_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
-    float val = result->classification[i].value;
+    float sum = 0.0f;
+    for (uint8_t k = 0; k < VOICE_MAF_LEN; k++) sum += g_maf[k][i];
+    float val = sum / VOICE_MAF_LEN;
     if (val > best_score) { best_score = val; best_ix = i; }
   }
 
   if (best_ix == SIZE_MAX) return;
+  const char *label = result->classification[best_ix].label;
+  if (is_background_label(label) || best_score < VOICE_CONF_THRESHOLD) return;
 
-  // label string:
-  String label = String(result->classification[best_ix].label);
-  // Emit to web clients and run mapping
-  String out = "VOICE_RX:" + label;
-  notifyClients(out);
-
-  // For debugging
-  Serial.printf("[Voice] EI label='%s' (score=%.3f)\n", result->classification[best_ix].label, best_score);
+  Serial.printf("[Voice] EI label='%s' (score=%.3f, dsp=%d ms, nn=%d ms)\n",
+                label, best_score, result->timing.dsp, result->timing.classification);
 
-  // If score is reasonably confident, perform the command mapping
-  const float CONF_THRESHOLD = 0.50f; // tune this: 0.5..0.8
-  if (best_score >= CONF_THRESHOLD) {
-    handleVoiceCommand(label); // uses your existing mapping that sets ws_setDirection/etc.
-  }
+  // handleVoiceCommand also echoes VOICE_RX:<label> to the web clients
+  handleVoiceCommand(String(label));
+  g_cooldown = EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW;
 }
 
 /**
- * Main voice loop — called from main loop() frequently.
- * If we have at least EI_CLASSIFIER_RAW_SAMPLE_COUNT samples, run classifier.
+ * Main voice loop — called from the net/voice task frequently.
+ * Maps browser transcripts, then classifies at most one new audio slice.
  */
 void voiceLoop() {
-  if (!g_ready_for_inference) return;
-  g_ready_for_inference = false;
+  // WINDOW: the web client sent "VOICE:<transcript>"; map text -> action
+  char text[WS_TRANSCRIPT_MAX];
+  while (wsTakeTranscript(text, sizeof(text)))
+    handleVoiceCommand(String(text));
+
+  VoiceSlice slice;
+  if (!voiceReadySlices.pop(slice)) return;
 
-  // Prepare signal_t
+  if (slice.afterGap) {
+    Serial.println("[Voice] audio (re)started, new model window");
+    reset_continuous();
+  }
+
+  // Prepare signal_t over just this slice
+  g_inferSlice = g_slices + (size_t)slice.buf * EI_CLASSIFIER_SLICE_SIZE;
   signal_t signal;
-  signal.total_length = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+  signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
   signal.get_data = &ei_signal_get_data;
 
   ei_impulse_result_t result = {0};
+  EI_IMPULSE_ERROR r = run_classifier_continuous(&signal, &result, false);
+
+  // hand the buffer back to microphone_feed
+  voiceFreeSlices.push(slice.buf);
 
-  // run classifier (non-continuous API)
-  EI_IMPULSE_ERROR r = run_classifier(&signal, &result, false);
   if (r != EI_IMPULSE_OK) {
-    Serial.printf("[Voice] run_classifier error: %d\n", r);
+    Serial.printf("[Voice] run_classifier_continuous error: %d\n", r);
     return;
   }
 
+  // feedback beep for recognised commands comes from the game task
   process_classification(&result);
-  // Optionally produce a beep feedback when something happened
-  playClickBeep();
 }
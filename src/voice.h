@@ -3,9 +3,23 @@
 
 #include <Arduino.h>
 
+#include "input.h"
+
 void initVoice();
-void voiceLoop();
-void handleVoiceCommand(const String &transcript);
+void voiceLoop();                                  // net/voice task only
+void handleVoiceCommand(const String &transcript); // net/voice task only
+
+// Commands recognised by the voice task, handed to the game task through a
+// lock-free SPSC queue (voice task = producer, game task = consumer)
+#define VOICE_EVENT_QUEUE_LEN 8
+void voicePushInput(const InputEvent &ev);
+bool voicePollEvent(InputEvent &ev);
+
+// Keyword spotting runs continuously on slices of the 1 s model window
+#define VOICE_SLICE_BUFFERS 3       // slice buffers shared with microphone_feed (<= 4)
+#define VOICE_MAF_LEN 2             // slices averaged before thresholding
+#define VOICE_CONF_THRESHOLD 0.50f  // tune this: 0.5..0.8
+#define VOICE_STREAM_GAP_MS 500     // longer pause in the audio = new stream
 
 // Called by web_control when it receives binary audio frames
 // samples: pointer to int16_t PCM samples (little-endian), count = number of samples
@@ -1,9 +1,10 @@
 // voice_actions.cpp
 // Re-introduces handleVoiceCommand(const String&) so linker resolves references.
-// Maps EI labels / transcripts to your existing websocket/game flags.
+// Maps EI labels / transcripts to input commands (applied via voicePushInput()).
 
 #include <Arduino.h>
-#include "web_control.h" // provides extern flags and notifyClients()
+#include "web_control.h" // provides notifyClients()
+#include "voice.h"    // voicePushInput()
 #include "buzzer.h"      // optional: playClickBeep()
 
 // forward declaration for playClickBeep() if buzzer.h doesn't provide it
@@ -40,45 +41,45 @@ void handleVoiceCommand(const String &transcript) {
       t.indexOf("MOVEUP") >= 0 || t.indexOf("MOVEUP") >= 0 ||
       t.indexOf("MOVEUP") >= 0 || t.indexOf("UP") >= 0 ||
       t.indexOf("MOVEUP") >= 0 || t.indexOf("UPSIDE") >= 0) {
-    ws_setDirection = 0; // up
+    voicePushInput({INPUT_DIRECTION, 0}); // up
     didAction = true;
   }
   // Move right
   else if (t.indexOf("MOVE_RIGHT") >= 0 || t.indexOf("MOVE RIGHT") >= 0 ||
            t.indexOf("MOVERIGHT") >= 0 || t.indexOf("RIGHT") >= 0) {
-    ws_setDirection = 1; // right
+    voicePushInput({INPUT_DIRECTION, 1}); // right
     didAction = true;
   }
   // Move down
   else if (t.indexOf("MOVE_DOWN") >= 0 || t.indexOf("MOVE DOWN") >= 0 ||
            t.indexOf("MOVEDOWN") >= 0 || t.indexOf("DOWN") >= 0 ||
            t.indexOf("DOWNWARDS") >= 0) {
-    ws_setDirection = 2; // down
+    voicePushInput({INPUT_DIRECTION, 2}); // down
     didAction = true;
   }
   // Move left
   else if (t.indexOf("MOVE_LEFT") >= 0 || t.indexOf("MOVE LEFT") >= 0 ||
            t.indexOf("MOVELEFT") >= 0 || t.indexOf("LEFT") >= 0) {
-    ws_setDirection = 3; // left
+    voicePushInput({INPUT_DIRECTION, 3}); // left
     didAction = true;
   }
   // Pause / play (toggle)
   else if (t.indexOf("PAUSE") >= 0 || t.indexOf("PAUSE_GAME") >= 0 || t.indexOf("PLAY_GAME") >= 0 || t.indexOf("PLAY") >= 0) {
-    ws_togglePause = true;
+    voicePushInput({INPUT_PAUSE, 0});
     didAction = true;
   }
   // Restart
   else if (t.indexOf("RESTART") >= 0 || t.indexOf("RESTART_GAME") >= 0 || t.indexOf("START OVER") >= 0) {
-    ws_needRestart = true;
+    voicePushInput({INPUT_RESTART, 0});
     didAction = true;
   }
   // Mute / unmute
   else if (t.indexOf("MUTE") >= 0 || t.indexOf("MUTE_SOUND") >= 0 || t.indexOf("MUTE_SOUND") >= 0) {
-    ws_toggleSound = true;
+    voicePushInput({INPUT_MUTE, 0});
     didAction = true;
   }
   else if (t.indexOf("UNMUTE") >= 0 || t.indexOf("SOUND ON") >= 0 || t.indexOf("UNMUTE_SOUND") >= 0) {
-    ws_toggleSound = true;
+    voicePushInput({INPUT_MUTE, 0});
     didAction = true;
   }
   // special short labels that may be noise indicators — don't trigger action
@@ -92,11 +93,8 @@ void handleVoiceCommand(const String &transcript) {
     Serial.println(t);
   }
 
-  // If action chosen, request beep & redraw for UI feedback
-  if (didAction) {
-    ws_needBeep = true;
-    ws_needRedraw = true;
-  }
+  // the beep & redraw feedback for the chosen action comes from applyInput()
+  // when the game task takes the queued command
 
   // Play feedback sound if available (optional)
   #ifdef playClickBeep
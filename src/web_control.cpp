@@ -7,22 +7,37 @@
 #include <AsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 #include "SPIFFS.h"
+#include "spsc_queue.h"
 
 // WiFi credentials (original names, change if needed)
 const char *ssid = "ENTER YOU WIFI SSID";
 const char *password = "ENTER YOUR WIFI PASSWORD";
 
-// websocket flags (same names)
-volatile bool ws_needBeep = false;
-volatile bool ws_needRedraw = false;
-volatile bool ws_needRestart = false;
-volatile int ws_setDirection = -1;
-volatile bool ws_togglePause = false;
-volatile bool ws_toggleSound = false;
+// AsyncTCP task -> game task / net-voice task handoff
+struct WsTranscript
+{
+  char text[WS_TRANSCRIPT_MAX];
+};
+static SpscQueue<InputEvent, WS_EVENT_QUEUE_LEN> wsEvents;
+static SpscQueue<WsTranscript, WS_TRANSCRIPT_QUEUE_LEN> wsTranscripts;
 
-// Voice command support (default values)
-volatile bool ws_voiceCommand = false;
-String ws_voiceTranscript = "";
+static void wsPush(InputType type, uint8_t arg = 0)
+{
+  InputEvent ev = {type, arg};
+  if (!wsEvents.push(ev))
+    Serial.println("WS: event queue full, dropped");
+}
+
+bool wsPollEvent(InputEvent &ev) { return wsEvents.pop(ev); }
+
+bool wsTakeTranscript(char *out, size_t outSize)
+{
+  WsTranscript t;
+  if (!wsTranscripts.pop(t)) return false;
+  strncpy(out, t.text, outSize - 1);
+  out[outSize - 1] = '\0';
+  return true;
+}
 
 
 extern void microphone_feed(const int16_t *samples, size_t count);
@@ -128,31 +143,32 @@ void handleIWebSocketMessage(void *arg, uint8_t *data, size_t len)
       return;
     }
 
-    // Existing command mapping (preserved)
-    if (msg.equals("UP_HIGH") && direction != 2) ws_setDirection = 0;
-    else if (msg.equals("DOWN_HIGH") && direction != 0) ws_setDirection = 2;
-    else if (msg.equals("LEFT_HIGH") && direction != 1) ws_setDirection = 3;
-    else if (msg.equals("RIGHT_HIGH") && direction != 3) ws_setDirection = 1;
-    else if (msg.equals("PAUSE_PLAY")) ws_togglePause = true;
-    else if (msg.equals("RESTART")) ws_needRestart = true;
-    else if (msg.equals("MUTE")) ws_toggleSound = true;
+    // Existing command mapping (preserved); reversal checks happen in the game
+    // core against the applied direction, not against a possibly stale read here
+    if (msg.equals("UP_HIGH")) wsPush(INPUT_DIRECTION, 0);
+    else if (msg.equals("DOWN_HIGH")) wsPush(INPUT_DIRECTION, 2);
+    else if (msg.equals("LEFT_HIGH")) wsPush(INPUT_DIRECTION, 3);
+    else if (msg.equals("RIGHT_HIGH")) wsPush(INPUT_DIRECTION, 1);
+    else if (msg.equals("PAUSE_PLAY")) wsPush(INPUT_PAUSE);
+    else if (msg.equals("RESTART")) wsPush(INPUT_RESTART);
+    else if (msg.equals("MUTE")) wsPush(INPUT_MUTE);
+    else if (msg.equals("REPLAY")) wsPush(INPUT_REPLAY);
     // Voice transcript from web client: format "VOICE:<transcript>"
     else if (msg.startsWith("VOICE:")) {
       String transcript = msg.substring(6);
       transcript.trim();
       if (transcript.length() > 0) {
-        ws_voiceTranscript = transcript;
-        ws_voiceCommand = true; // main loop will pick this up and call handleVoiceCommand()
-        Serial.printf("WS: voice transcript queued: %s\n", transcript.c_str());
+        WsTranscript t;
+        strncpy(t.text, transcript.c_str(), sizeof(t.text) - 1);
+        t.text[sizeof(t.text) - 1] = '\0';
+        if (wsTranscripts.push(t)) {
+          Serial.printf("WS: voice transcript queued: %s\n", t.text);
+        } else {
+          Serial.println("WS: transcript queue full, dropped");
+        }
       }
     }
 
-    if (ws_setDirection >= 0 || ws_togglePause || ws_toggleSound)
-    {
-      ws_needBeep = true;
-      ws_needRedraw = true;
-    }
-
     // done with text frame
     return;
   }
@@ -4,17 +4,17 @@
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
 
-// websocket flags (kept names)
-extern volatile bool ws_needBeep;
-extern volatile bool ws_needRedraw;
-extern volatile bool ws_needRestart;
-extern volatile int ws_setDirection; // -1 = no change, 0..3
-extern volatile bool ws_togglePause;
-extern volatile bool ws_toggleSound;
-
-// voice: browser -> ESP signaling (set when web client sends "VOICE:<transcript>")
-extern volatile bool ws_voiceCommand;      // set true by websocket when transcript arrives
-extern String ws_voiceTranscript;          // transcript content (not volatile; updated by ws handler)
+#include "input.h"
+
+// The AsyncTCP task hands commands to the game task through a lock-free SPSC
+// queue (AsyncTCP task = producer, game task = consumer). "VOICE:<transcript>"
+// text goes through its own SPSC queue to the net/voice task, which maps it.
+#define WS_EVENT_QUEUE_LEN      16
+#define WS_TRANSCRIPT_QUEUE_LEN 4
+#define WS_TRANSCRIPT_MAX       64
+
+bool wsPollEvent(InputEvent &ev);                 // game task only
+bool wsTakeTranscript(char *out, size_t outSize); // net/voice task only
 
 // helper functions provided by web_control.cpp
 void initFS();
@@ -0,0 +1,131 @@
+"""Convert data/logo.jpg into a run-length encoded RGB565 splash in flash.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini)
+and writes include/splash_rle.h, which display.cpp streams to the panel
+instead of decoding the JPEG from SPIFFS. The header is regenerated only
+when the JPEG is newer. Needs Pillow in PlatformIO's Python:
+
+    ~/.platformio/penv/bin/pip install pillow
+
+Without Pillow the header is not generated and the firmware falls back to
+the JPEG. Can also be run by hand: python tools/build_splash.py
+
+Format: a stream of packets over big-endian RGB565 pixels. A control byte
+c >= 0x80 is a run of (c & 0x7F) + 1 copies of the one pixel that follows;
+c < 0x80 is c + 1 literal pixels.
+"""
+
+import os
+import sys
+
+MAX_PACKET = 128
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def encode(pixels):
+    """PackBits-style RLE of a list of 16-bit pixels."""
+    out = bytearray()
+    n = len(pixels)
+    i = 0
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_PACKET]
+            del literal[:MAX_PACKET]
+            out.append(len(chunk) - 1)
+            for p in chunk:
+                out.extend((p >> 8, p & 0xFF))
+
+    while i < n:
+        run = 1
+        while i + run < n and run < MAX_PACKET and pixels[i + run] == pixels[i]:
+            run += 1
+        # a run of two costs the same as two literals; only break a literal
+        # for three or more
+        if run >= 3 or (run == 2 and not literal):
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out += bytes((pixels[i] >> 8, pixels[i] & 0xFF))
+            i += run
+        else:
+            literal.append(pixels[i])
+            i += 1
+    flush_literal()
+    return bytes(out)
+
+
+def decode(data):
+    """Reference decoder, used to verify the encoder output."""
+    pixels = []
+    i = 0
+    while i < len(data):
+        c = data[i]
+        i += 1
+        if c & 0x80:
+            p = (data[i] << 8) | data[i + 1]
+            i += 2
+            pixels += [p] * ((c & 0x7F) + 1)
+        else:
+            for _ in range(c + 1):
+                pixels.append((data[i] << 8) | data[i + 1])
+                i += 2
+    return pixels
+
+
+def load_pixels(path):
+    from PIL import Image
+
+    img = Image.open(path).convert("RGB")
+    w, h = img.size
+    return w, h, [rgb565(r, g, b) for (r, g, b) in img.getdata()]
+
+
+def write_header(path, w, h, data, source):
+    lines = [
+        "// Generated by tools/build_splash.py from %s - do not edit" % source,
+        "#ifndef SPLASH_RLE_H",
+        "#define SPLASH_RLE_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define SPLASH_RLE_WIDTH %d" % w,
+        "#define SPLASH_RLE_HEIGHT %d" % h,
+        "",
+        "// %d bytes (raw RGB565 would be %d)" % (len(data), w * h * 2),
+        "static const uint8_t SPLASH_RLE[] = {",
+    ]
+    for k in range(0, len(data), 20):
+        lines.append("    " + ", ".join("0x%02X" % b for b in data[k:k + 20]) + ",")
+    lines += ["};", "", "#endif // SPLASH_RLE_H", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def build(project_dir):
+    src = os.path.join(project_dir, "data", "logo.jpg")
+    dst = os.path.join(project_dir, "include", "splash_rle.h")
+    if not os.path.exists(src):
+        return
+    if os.path.exists(dst) and os.path.getmtime(dst) >= os.path.getmtime(src):
+        return
+    try:
+        w, h, pixels = load_pixels(src)
+    except ImportError:
+        print("build_splash: Pillow not installed, keeping the JPEG splash")
+        return
+    data = encode(pixels)
+    assert decode(data) == pixels
+    write_header(dst, w, h, data, "data/logo.jpg")
+    print("build_splash: %s %dx%d, %d bytes RLE" % (dst, w, h, len(data)))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    build(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))